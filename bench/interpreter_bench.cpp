@@ -0,0 +1,223 @@
+// interpreter_bench.cpp
+//
+// Micro-benchmark for the instruction interpreter. Generates a fixed set of random
+// programs with create_random_process() and runs each of them to completion with:
+//   - legacy:   the original string-compare dispatch over Instruction (reproduced below)
+//   - switch:   the decoded-bytecode interpreter with switch dispatch
+//   - threaded: the decoded-bytecode interpreter with direct-threaded dispatch
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread -I. bench/interpreter_bench.cpp bytecode.cpp cfs.cpp config.cpp
+//       core_pool.cpp instructions.cpp mem_manager.cpp mlfq.cpp process_log.cpp ready_queue.cpp run_queues.cpp
+//       scheduler.cpp shared_globals.cpp tick_clock.cpp timer_wheel.cpp timestamp.cpp -o interpreter_bench
+// Usage: interpreter_bench [processes] [rounds]
+
+#include "shared_globals.h"
+#include "mem_manager.h"
+#include "scheduler.h"
+#include "instructions.h"
+#include "bytecode.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// --- Legacy interpreter: string opcodes, per-access parsing and map lookups ---
+
+struct LegacyProcess {
+    Process* process = nullptr;
+    std::map<std::string, uint16_t> offsets;
+    uint16_t next_offset = 0;
+    std::vector<std::string> logs; // The original unbounded Process::logs
+};
+
+bool legacy_is_number(const std::string& s) {
+    if (s.empty()) return false;
+    size_t start_idx = (s[0] == '-') ? 1 : 0;
+    if (start_idx == 1 && s.length() == 1) return false;
+    return std::all_of(s.begin() + start_idx, s.end(), ::isdigit);
+}
+
+uint16_t legacy_address(LegacyProcess& lp, const std::string& name, bool create) {
+    if (lp.offsets.count(name)) return lp.offsets[name];
+    if (create) {
+        if (lp.next_offset + sizeof(uint16_t) > SYMBOL_TABLE_SIZE) return std::numeric_limits<uint16_t>::max();
+        lp.offsets[name] = lp.next_offset;
+        lp.next_offset += sizeof(uint16_t);
+        return lp.offsets[name];
+    }
+    lp.process->state = ProcessState::CRASHED;
+    return 0;
+}
+
+uint16_t legacy_read(LegacyProcess& lp, const std::string& arg) {
+    if (legacy_is_number(arg)) {
+        long v = std::stol(arg);
+        if (v < 0 || v > std::numeric_limits<uint16_t>::max()) { lp.process->state = ProcessState::CRASHED; return 0; }
+        return static_cast<uint16_t>(v);
+    }
+    uint16_t addr = legacy_address(lp, arg, false);
+    if (lp.process->state == ProcessState::CRASHED) return 0;
+    uint16_t value = 0;
+    global_mem_manager->readMemory(lp.process->id, addr, value);
+    return value;
+}
+
+void legacy_write(LegacyProcess& lp, const std::string& name, uint16_t value) {
+    uint16_t addr = legacy_address(lp, name, true);
+    if (addr == std::numeric_limits<uint16_t>::max()) return;
+    global_mem_manager->writeMemory(lp.process->id, addr, value);
+}
+
+void legacy_dispatch(LegacyProcess& lp, const Instruction& instr) {
+    Process* p = lp.process;
+    if (instr.opcode == "PRINT") {
+        std::stringstream log;
+        log << get_timestamp() << " Core:" << p->assigned_core << " \"";
+        for (size_t i = 0; i < instr.args.size(); ++i) {
+            if (lp.offsets.count(instr.args[i])) log << legacy_read(lp, instr.args[i]);
+            else log << instr.args[i];
+            if (i < instr.args.size() - 1) log << " ";
+        }
+        log << "\"";
+        lp.logs.push_back(log.str());
+    }
+    else if (instr.opcode == "DECLARE") {
+        legacy_write(lp, instr.args[0], static_cast<uint16_t>(std::stol(instr.args[1])));
+    }
+    else if (instr.opcode == "ADD") {
+        uint32_t sum = static_cast<uint32_t>(legacy_read(lp, instr.args[1])) + legacy_read(lp, instr.args[2]);
+        legacy_write(lp, instr.args[0], static_cast<uint16_t>(std::min<uint32_t>(sum, 65535)));
+    }
+    else if (instr.opcode == "SUBTRACT") {
+        uint16_t a = legacy_read(lp, instr.args[1]);
+        uint16_t b = legacy_read(lp, instr.args[2]);
+        legacy_write(lp, instr.args[0], a - b);
+    }
+    else if (instr.opcode == "SLEEP") {
+        std::stol(instr.args[0]);
+    }
+    else if (instr.opcode == "READ") {
+        uint16_t address = static_cast<uint16_t>(std::stoul(instr.args[1], nullptr, 16));
+        uint16_t value = 0;
+        if (!global_mem_manager->readMemory(p->id, address, value)) { p->state = ProcessState::CRASHED; return; }
+        legacy_write(lp, instr.args[0], value);
+    }
+    else if (instr.opcode == "WRITE") {
+        uint16_t address = static_cast<uint16_t>(std::stoul(instr.args[0], nullptr, 16));
+        uint16_t value = legacy_read(lp, instr.args[1]);
+        if (!global_mem_manager->writeMemory(p->id, address, value)) p->state = ProcessState::CRASHED;
+    }
+    else {
+        p->state = ProcessState::CRASHED;
+    }
+}
+
+uint64_t run_legacy(std::vector<Process*>& processes) {
+    uint64_t steps = 0;
+    for (Process* p : processes) {
+        LegacyProcess lp;
+        lp.process = p;
+        while (p->state != ProcessState::CRASHED && p->program_counter < static_cast<int>(p->instructions.size())) {
+            legacy_dispatch(lp, p->instructions[p->program_counter]);
+            p->program_counter++;
+            steps++;
+        }
+    }
+    return steps;
+}
+
+uint64_t run_decoded(std::vector<Process*>& processes) {
+    uint64_t steps = 0;
+    for (Process* p : processes) {
+        compile_program(p);
+        while (p->state != ProcessState::CRASHED && p->program_counter < static_cast<int>(p->program.code.size())) {
+            // SLEEP leaves the process WAITING; wake it immediately, there is no clock here.
+            p->state = ProcessState::RUNNING;
+            steps += execute_instructions(p, std::numeric_limits<int>::max());
+        }
+        flush_registers(p);
+    }
+    return steps;
+}
+
+// The generated programs, registered with a fresh memory manager. They are regenerated
+// from the same seed and pids each time (Process is not copyable), so every backend
+// starts from identical state.
+std::vector<Process*> load(int process_count) {
+    delete global_mem_manager;
+    global_mem_manager = new MemoryManager(global_config);
+    g_next_pid = 1;
+    std::mt19937 rng(42);
+    std::vector<Process*> processes;
+    for (int i = 0; i < process_count; ++i) {
+        Process* p = create_random_process("bench" + std::to_string(i), 0, rng);
+        p->state = ProcessState::RUNNING;
+        p->assigned_core = 0;
+        global_mem_manager->createProcess(*p);
+        processes.push_back(p);
+    }
+    return processes;
+}
+
+void unload(std::vector<Process*>& processes) {
+    for (Process* p : processes) delete p;
+    processes.clear();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int process_count = (argc > 1) ? std::atoi(argv[1]) : 64;
+    int rounds = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+    global_config.min_ins = 1000;
+    global_config.max_ins = 2000;
+    global_config.max_overall_mem = 65536;
+    global_config.mem_per_frame = 256;
+    global_config.min_mem_per_proc = 256;
+    global_config.max_mem_per_proc = 1024;
+
+    struct Backend {
+        const char* name;
+        InterpreterType type;
+        uint64_t (*run)(std::vector<Process*>&);
+    };
+    const Backend backends[] = {
+        { "legacy",   InterpreterType::SWITCH,   run_legacy },
+        { "switch",   InterpreterType::SWITCH,   run_decoded },
+        { "threaded", InterpreterType::THREADED, run_decoded },
+    };
+
+    std::cout << "\n" << process_count << " programs, best of " << rounds << " rounds\n";
+    for (const Backend& backend : backends) {
+        global_config.interpreter_type = backend.type;
+        double best_ms = std::numeric_limits<double>::max();
+        uint64_t steps = 0;
+        for (int round = 0; round < rounds; ++round) {
+            std::vector<Process*> processes = load(process_count);
+            auto start = std::chrono::steady_clock::now();
+            steps = backend.run(processes);
+            auto end = std::chrono::steady_clock::now();
+            best_ms = std::min(best_ms, std::chrono::duration<double, std::milli>(end - start).count());
+            unload(processes);
+        }
+        std::cout << std::left << std::setw(10) << backend.name
+            << std::right << std::setw(10) << steps << " instructions "
+            << std::fixed << std::setprecision(2) << std::setw(10) << best_ms << " ms "
+            << std::setw(8) << (steps / best_ms / 1000.0) << " M instr/s\n";
+    }
+
+    delete global_mem_manager;
+    global_mem_manager = nullptr;
+    return 0;
+}
@@ -0,0 +1,209 @@
+#include "bytecode.h"
+#include "process.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+bool is_number(const std::string& s) {
+    if (s.empty()) return false;
+    size_t start_idx = 0;
+    if (s[0] == '-') {
+        start_idx = 1;
+        if (s.length() == 1) return false;
+    }
+    return std::all_of(s.begin() + start_idx, s.end(), ::isdigit);
+}
+
+bool parse_hex_address(const std::string& s, uint16_t& out_address) {
+    if (s.empty()) return false;
+    try {
+        // Use std::stoul which can handle "0x" prefixes automatically.
+        // The third argument '16' specifies the base (hexadecimal).
+        unsigned long value = std::stoul(s, nullptr, 16);
+        if (value > std::numeric_limits<uint16_t>::max()) {
+            return false; // Value is too large for a uint16_t address
+        }
+        out_address = static_cast<uint16_t>(value);
+        return true;
+    }
+    catch (const std::invalid_argument& e) {
+        return false; // Not a valid number
+    }
+    catch (const std::out_of_range& e) {
+        return false; // Out of range for unsigned long
+    }
+}
+
+namespace {
+
+// Interns strings into Program::names during a single compile_program call.
+class NameTable {
+public:
+    explicit NameTable(std::vector<std::string>& names) : names_(names) {
+        for (uint32_t i = 0; i < names_.size(); ++i) {
+            index_.emplace(names_[i], i);
+        }
+    }
+
+    uint32_t intern(const std::string& name) {
+        auto it = index_.find(name);
+        if (it != index_.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(names_.size());
+        names_.push_back(name);
+        index_.emplace(name, id);
+        return id;
+    }
+
+private:
+    std::vector<std::string>& names_;
+    std::unordered_map<std::string, uint32_t> index_;
+};
+
+// Parses a uint16 literal the same way the handlers did with std::stol.
+bool parse_u16(const std::string& s, uint16_t& out) {
+    try {
+        long val_long = std::stol(s);
+        if (val_long < 0 || val_long > std::numeric_limits<uint16_t>::max()) return false;
+        out = static_cast<uint16_t>(val_long);
+        return true;
+    }
+    catch (...) { return false; }
+}
+
+Operand variable_operand(NameTable& names, const std::string& name) {
+    return { OperandKind::VARIABLE, names.intern(name) };
+}
+
+// A source operand is either a numeric literal or a variable reference.
+Operand source_operand(NameTable& names, const std::string& arg) {
+    if (is_number(arg)) {
+        uint16_t value;
+        if (!parse_u16(arg, value)) return { OperandKind::INVALID, 0 };
+        return { OperandKind::IMMEDIATE, value };
+    }
+    return variable_operand(names, arg);
+}
+
+// Picks the ADD/SUBTRACT variant specialized on the operand kinds. An INVALID operand
+// keeps the generic opcode, whose handler crashes the process when it reads it.
+OpCode arithmetic_opcode(bool add, const Operand& lhs, const Operand& rhs) {
+    static const OpCode variants[2][2][2] = {
+        { { OpCode::SUBTRACT_VAR_VAR, OpCode::SUBTRACT_VAR_IMM },
+          { OpCode::SUBTRACT_IMM_VAR, OpCode::SUBTRACT_IMM_IMM } },
+        { { OpCode::ADD_VAR_VAR, OpCode::ADD_VAR_IMM },
+          { OpCode::ADD_IMM_VAR, OpCode::ADD_IMM_IMM } },
+    };
+    if (lhs.kind == OperandKind::INVALID || rhs.kind == OperandKind::INVALID) {
+        return add ? OpCode::ADD : OpCode::SUBTRACT;
+    }
+    return variants[add][lhs.kind == OperandKind::IMMEDIATE][rhs.kind == OperandKind::IMMEDIATE];
+}
+
+DecodedInstruction invalid(NameTable& names, const std::string& message = "") {
+    DecodedInstruction decoded;
+    decoded.op = OpCode::INVALID;
+    if (!message.empty()) decoded.error_text = names.intern(message);
+    return decoded;
+}
+
+DecodedInstruction decode(const Instruction& instr, NameTable& names) {
+    DecodedInstruction decoded;
+    const std::vector<std::string>& args = instr.args;
+
+    if (instr.opcode == "PRINT") {
+        decoded.op = OpCode::PRINT;
+        decoded.print_args.reserve(args.size());
+        for (const std::string& arg : args) {
+            // Whether an argument prints as a variable or as literal text is only
+            // known at run time, so every argument is kept as a name reference.
+            decoded.print_args.push_back(variable_operand(names, arg));
+        }
+    }
+    else if (instr.opcode == "DECLARE") {
+        uint16_t value;
+        if (args.size() != 2 || !parse_u16(args[1], value)) return invalid(names);
+        decoded.op = OpCode::DECLARE;
+        decoded.dest = variable_operand(names, args[0]);
+        decoded.src1 = { OperandKind::IMMEDIATE, value };
+    }
+    else if (instr.opcode == "ADD" || instr.opcode == "SUBTRACT") {
+        if (args.size() != 3) return invalid(names);
+        decoded.dest = variable_operand(names, args[0]);
+        decoded.src1 = source_operand(names, args[1]);
+        decoded.src2 = source_operand(names, args[2]);
+        decoded.op = arithmetic_opcode(instr.opcode == "ADD", decoded.src1, decoded.src2);
+    }
+    else if (instr.opcode == "SLEEP") {
+        if (args.size() != 1) return invalid(names);
+        try {
+            long sleep_val = std::stol(args[0]);
+            if (sleep_val < 0 || sleep_val > 255) return invalid(names);
+            decoded.op = OpCode::SLEEP;
+            decoded.count = static_cast<uint32_t>(sleep_val);
+        }
+        catch (...) { return invalid(names); }
+    }
+    else if (instr.opcode == "FOR") {
+        if (args.size() != 1) return invalid(names);
+        try {
+            int repeat_count = std::stoi(args[0]);
+            decoded.op = OpCode::FOR;
+            decoded.count = repeat_count > 0 ? static_cast<uint32_t>(repeat_count) : 0;
+        }
+        catch (...) { return invalid(names); }
+        decoded.body.reserve(instr.sub_instructions.size());
+        for (const Instruction& sub : instr.sub_instructions) {
+            decoded.body.push_back(decode(sub, names));
+        }
+    }
+    else if (instr.opcode == "READ") {
+        if (args.size() != 2) return invalid(names, "READ requires 2 arguments.");
+        if (!parse_hex_address(args[1], decoded.address)) {
+            return invalid(names, "Invalid hexadecimal address '" + args[1] + "'.");
+        }
+        decoded.op = OpCode::READ;
+        decoded.dest = variable_operand(names, args[0]);
+    }
+    else if (instr.opcode == "WRITE") {
+        if (args.size() != 2) return invalid(names, "WRITE requires 2 arguments.");
+        if (!parse_hex_address(args[0], decoded.address)) {
+            return invalid(names, "Invalid hexadecimal address '" + args[0] + "'.");
+        }
+        decoded.op = OpCode::WRITE;
+        decoded.src1 = source_operand(names, args[1]);
+    }
+    else {
+        return invalid(names, "Unknown instruction '" + instr.opcode + "'.");
+    }
+    return decoded;
+}
+
+} // namespace
+
+void compile_program(Process* process) {
+    Program& program = process->program;
+    if (program.code.size() >= process->instructions.size()) return;
+
+    // The log display reads 'names' from another thread while this appends to it.
+    std::lock_guard<std::mutex> log_lock(process->logs.mutex());
+    NameTable names(program.names);
+    program.code.reserve(process->instructions.size());
+    for (size_t i = program.code.size(); i < process->instructions.size(); ++i) {
+        program.code.push_back(decode(process->instructions[i], names));
+    }
+
+    // Resolve every name to a symbol-table slot lookup the interpreter can index directly.
+    process->symbol_slots.resize(program.names.size(), UNDECLARED_SLOT);
+
+    // Appending may have moved 'code', so point active loop frames at the new bodies.
+    // Each enclosing frame's current instruction is the FOR that owns the next frame.
+    const std::vector<DecodedInstruction>* body = nullptr;
+    for (size_t depth = 0; depth < process->for_stack.size(); ++depth) {
+        const DecodedInstruction& owner = (depth == 0)
+            ? program.code[process->program_counter]
+            : (*body)[process->for_stack[depth - 1].current_instruction_index];
+        body = &owner.body;
+        process->for_stack[depth].body = body;
+    }
+}
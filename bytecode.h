@@ -0,0 +1,77 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct Process; // Forward-declare Process to avoid circular include with process.h
+
+// Decoded form of an Instruction's opcode string.
+enum class OpCode : uint8_t {
+    PRINT,
+    DECLARE,
+    ADD,
+    SUBTRACT,
+    SLEEP,
+    FOR,
+    READ,
+    WRITE,
+    // ADD/SUBTRACT specialized on the operand kinds (variable or immediate lhs/rhs),
+    // selected by compile_program. Plain ADD/SUBTRACT keep an operand that failed to decode.
+    ADD_VAR_VAR,
+    ADD_VAR_IMM,
+    ADD_IMM_VAR,
+    ADD_IMM_IMM,
+    SUBTRACT_VAR_VAR,
+    SUBTRACT_VAR_IMM,
+    SUBTRACT_IMM_VAR,
+    SUBTRACT_IMM_IMM,
+    INVALID // Malformed or unknown instruction. Crashes the process when executed.
+};
+
+// How an operand was resolved when the program was compiled.
+enum class OperandKind : uint8_t {
+    NONE,
+    IMMEDIATE, // 'value' holds the pre-parsed uint16 literal
+    VARIABLE,  // 'value' indexes Program::names
+    INVALID    // A literal that does not fit in a uint16. Crashes the process when read.
+};
+
+struct Operand {
+    OperandKind kind = OperandKind::NONE;
+    uint32_t value = 0;
+};
+
+struct DecodedInstruction {
+    OpCode op = OpCode::INVALID;
+    Operand dest;                          // DECLARE/ADD/SUBTRACT/READ target variable
+    Operand src1;                          // DECLARE value, ADD/SUBTRACT lhs, WRITE value
+    Operand src2;                          // ADD/SUBTRACT rhs
+    uint16_t address = 0;                  // READ/WRITE pre-parsed hex address
+    uint32_t count = 0;                    // SLEEP ticks or FOR repeat count
+    uint32_t error_text = NO_TEXT;         // INVALID: index into Program::names of the error message
+    std::vector<Operand> print_args;       // PRINT arguments
+    std::vector<DecodedInstruction> body;  // FOR loop body
+
+    static const uint32_t NO_TEXT = UINT32_MAX;
+};
+
+// The compiled form of Process::instructions. code[i] is the decoded form of
+// instructions[i], so program_counter indexes both.
+struct Program {
+    std::vector<DecodedInstruction> code;
+    std::vector<std::string> names; // Variable names, PRINT literals and error messages
+};
+
+/**
+ * @brief Compiles any instructions not yet present in process->program.
+ *
+ * Instructions are only ever appended to a process (screen -c, the interactive
+ * process screen), so compilation is incremental: already decoded entries are kept.
+ *
+ * @param process The process whose instruction list is to be compiled.
+ */
+void compile_program(Process* process);
+
+#endif // BYTECODE_H
@@ -0,0 +1,65 @@
+#include "cfs.h"
+#include "shared_globals.h"
+#include <algorithm>
+#include <atomic>
+
+// Linux's nice-to-weight table: each nice level is about 10% more or less CPU time
+// than the next. Priorities 0..99 map onto nice -20..19.
+static const int NICE_WEIGHTS[40] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+    9548, 7620, 6100, 4904, 3906,
+    3121, 2501, 1991, 1586, 1277,
+    1024, 820, 655, 526, 423,
+    335, 272, 215, 172, 137,
+    110, 87, 70, 56, 45,
+    36, 29, 23, 18, 15
+};
+
+// vruntime per instruction of a nice-0 process. Keeps heavy processes' charges from
+// rounding down to nothing.
+static const uint64_t VRUNTIME_PER_INSTRUCTION = 1024;
+
+// Never decreases. Read and raised by every core without a lock.
+static std::atomic<uint64_t> min_vruntime{ 0 };
+
+int cfs_weight(const Process* process) {
+    int priority = std::clamp(process->priority, 0, 99);
+    return NICE_WEIGHTS[priority * 40 / 100];
+}
+
+int cfs_slice(const Process* process) {
+    int runnable = static_cast<int>(run_queues.size()) + 1;
+    int per_core = (runnable + global_config.num_cpu - 1) / global_config.num_cpu;
+    // The others sharing this core are counted as nice-0.
+    int64_t weight = cfs_weight(process);
+    int64_t slice = global_config.cfs_latency * weight /
+        (weight + static_cast<int64_t>(per_core - 1) * CFS_NICE_0_WEIGHT);
+    return static_cast<int>(std::max<int64_t>(slice, global_config.cfs_min_granularity));
+}
+
+void cfs_place(Process* process) {
+    if (process->cfs_requeued) {
+        process->cfs_requeued = false;
+        return;
+    }
+    process->vruntime = std::max(process->vruntime, min_vruntime.load(std::memory_order_relaxed));
+}
+
+void cfs_end_slice(Process* process, int executed) {
+    process->vruntime += static_cast<uint64_t>(std::max(executed, 0)) *
+        VRUNTIME_PER_INSTRUCTION * CFS_NICE_0_WEIGHT / cfs_weight(process);
+
+    // Preempted or out of slice, it goes straight back to a queue with the vruntime it
+    // earned; only a sleeper is placed again when it wakes.
+    process->cfs_requeued = process->state != ProcessState::WAITING;
+
+    // The minimum follows the leftmost waiting vruntime. Processes running on other
+    // cores may be behind it, which is harmless: they are not placed when their slice
+    // ends.
+    int64_t waiting = run_queues.best_waiting_key();
+    if (waiting == ReadyQueue::NO_WAITING_KEY) return;
+    uint64_t floor = static_cast<uint64_t>(waiting);
+    uint64_t current = min_vruntime.load(std::memory_order_relaxed);
+    while (floor > current && !min_vruntime.compare_exchange_weak(current, floor)) {}
+}
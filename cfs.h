@@ -0,0 +1,33 @@
+#ifndef CFS_H
+#define CFS_H
+
+#include <cstdint>
+#include "process.h"
+
+// Completely fair scheduling ("cfs" policy). Each process accumulates a virtual
+// runtime: the instructions it has run, scaled down by a weight taken from its
+// priority (lower priority value, higher weight). The ready queue keys processes on
+// vruntime, so the one that has had the least weighted CPU time runs next. A slice is
+// cfs-latency shared among the processes runnable per core, weighted the same way,
+// but never less than cfs-min-granularity, so switching overhead grows with the load
+// instead of being fixed by a quantum.
+
+// Weight of a process with nice-0 priority (priority 50).
+const int CFS_NICE_0_WEIGHT = 1024;
+
+// Scheduling weight of 'process', from its priority.
+int cfs_weight(const Process* process);
+
+// Instructions 'process' may run in its current slice, given the current load.
+int cfs_slice(const Process* process);
+
+// Brings a process that is being queued up to the queue's minimum vruntime, so a new
+// or long-sleeping process cannot monopolize the cores until it has caught up. A
+// process coming straight back from its slice keeps its vruntime.
+void cfs_place(Process* process);
+
+// Charges 'executed' instructions to the process's vruntime and advances the minimum
+// to the leftmost waiting vruntime.
+void cfs_end_slice(Process* process, int executed);
+
+#endif // CFS_H
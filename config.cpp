@@ -13,6 +13,13 @@ const int DEFAULT_MIN_INS = 1000;
 const int DEFAULT_MAX_INS = 2000;
 const int DEFAULT_DELAY_PER_EXEC = 0;
 const char* const DEFAULT_SCHEDULER = "rr";
+const char* const DEFAULT_INTERPRETER = "switch";
+const int DEFAULT_LOG_CAPACITY = 1024;
+const int DEFAULT_MLFQ_LEVELS = 3;
+const int DEFAULT_MLFQ_BOOST_TICKS = 500;
+const int DEFAULT_CFS_LATENCY = 100;
+const int DEFAULT_CFS_MIN_GRANULARITY = 10;
+const int DEFAULT_DOMAIN_IMBALANCE = 2;
 
 // --- NEW DEFAULTS FOR MEMORY ---
 const int DEFAULT_MAX_OVERALL_MEM = 16384; // 2^14
@@ -39,6 +46,10 @@ bool loadConfiguration(const std::string& filepath, Config& config) {
         ss >> key;
 
         if (key == "num-cpu") ss >> config.num_cpu;
+        else if (key == "host-threads") ss >> config.host_threads;
+        else if (key == "sched-domains") ss >> config.sched_domains;
+        else if (key == "domain-imbalance") ss >> config.domain_imbalance;
+        else if (key == "pin-host-threads") ss >> config.pin_host_threads;
         else if (key == "scheduler") {
             std::string value;
             ss >> value;
@@ -53,10 +64,39 @@ bool loadConfiguration(const std::string& filepath, Config& config) {
             else if (value == "priority_np") config.scheduler_type = SchedulerType::PRIORITY_NONPREEMPTIVE;
             else if (value == "priority_p") config.scheduler_type = SchedulerType::PRIORITY_PREEMPTIVE;
             else if (value == "rr") config.scheduler_type = SchedulerType::RR;
+            else if (value == "mlfq") config.scheduler_type = SchedulerType::MLFQ;
+            else if (value == "cfs") config.scheduler_type = SchedulerType::CFS;
+            else if (value == "edf") config.scheduler_type = SchedulerType::EDF;
             else config.scheduler_type = SchedulerType::UNKNOWN;
         }
+        else if (key == "interpreter") {
+            std::string value;
+            ss >> value;
+            if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+                value = value.substr(1, value.length() - 2);
+            }
+            config.interpreter = value;
+
+            if (value == "switch") config.interpreter_type = InterpreterType::SWITCH;
+            else if (value == "threaded") config.interpreter_type = InterpreterType::THREADED;
+            else config.interpreter_type = InterpreterType::UNKNOWN;
+        }
+        else if (key == "log-capacity") ss >> config.log_capacity;
+        else if (key == "log-spill") ss >> config.log_spill;
+        else if (key == "virtual-time") ss >> config.virtual_time;
+        else if (key == "seed") config.deterministic = static_cast<bool>(ss >> config.seed);
         else if (key == "quantum-cycles") ss >> config.quantum_cycles;
+        else if (key == "mlfq-levels") ss >> config.mlfq_levels;
+        else if (key == "mlfq-quanta") {
+            config.mlfq_quanta.clear();
+            int quantum;
+            while (ss >> quantum) config.mlfq_quanta.push_back(quantum);
+        }
+        else if (key == "mlfq-boost-ticks") ss >> config.mlfq_boost_ticks;
+        else if (key == "cfs-latency") ss >> config.cfs_latency;
+        else if (key == "cfs-min-granularity") ss >> config.cfs_min_granularity;
         else if (key == "batch-process-freq") ss >> config.batch_process_freq;
+        else if (key == "batch-deadline") ss >> config.batch_deadline;
         else if (key == "min-ins") ss >> config.min_ins;
         else if (key == "max-ins") ss >> config.max_ins;
         else if (key == "delay-per-exec") ss >> config.delay_per_exec;
@@ -76,11 +116,26 @@ bool loadConfiguration(const std::string& filepath, Config& config) {
 bool correctAndValidateConfig(Config& config) {
     bool corrected = false;
 
-    if (config.num_cpu < 1 || config.num_cpu > 128) {
-        std::cerr << "Correcting num-cpu from " << config.num_cpu << " to " << DEFAULT_NUM_CPU << "\n";
+    if (config.num_cpu < 1 || config.num_cpu > MAX_NUM_CPU) {
+        std::cerr << "Correcting num-cpu from " << config.num_cpu << " to " << DEFAULT_NUM_CPU << " (1 <= n <= " << MAX_NUM_CPU << ")\n";
         config.num_cpu = DEFAULT_NUM_CPU;
         corrected = true;
     }
+    if (config.host_threads < 0) {
+        std::cerr << "Correcting host-threads to 0 (one per hardware thread)\n";
+        config.host_threads = 0;
+        corrected = true;
+    }
+    if (config.sched_domains < 1 || config.sched_domains > config.num_cpu) {
+        std::cerr << "Correcting sched-domains from " << config.sched_domains << " to 1 (1 <= n <= num-cpu)\n";
+        config.sched_domains = 1;
+        corrected = true;
+    }
+    if (config.domain_imbalance < 1) {
+        std::cerr << "Correcting domain-imbalance to " << DEFAULT_DOMAIN_IMBALANCE << "\n";
+        config.domain_imbalance = DEFAULT_DOMAIN_IMBALANCE;
+        corrected = true;
+    }
     if (config.scheduler_type == SchedulerType::UNKNOWN) {
         std::cerr << "Invalid scheduler type. Defaulting to " << DEFAULT_SCHEDULER << ".\n";
         config.scheduler = DEFAULT_SCHEDULER;
@@ -89,16 +144,82 @@ bool correctAndValidateConfig(Config& config) {
         else config.scheduler_type = SchedulerType::UNKNOWN;
         corrected = true;
     }
-    if (config.scheduler_type == SchedulerType::RR && config.quantum_cycles < 1) {
+    if (config.interpreter_type == InterpreterType::UNKNOWN) {
+        std::cerr << "Invalid interpreter '" << config.interpreter << "'. Defaulting to " << DEFAULT_INTERPRETER << ".\n";
+        config.interpreter = DEFAULT_INTERPRETER;
+        config.interpreter_type = InterpreterType::SWITCH;
+        corrected = true;
+    }
+    if (config.log_capacity < 1) {
+        std::cerr << "Correcting log-capacity to " << DEFAULT_LOG_CAPACITY << "\n";
+        config.log_capacity = DEFAULT_LOG_CAPACITY;
+        corrected = true;
+    }
+    if (config.deterministic && !config.virtual_time) {
+        // A wall-clock tick ends whether or not every core got to run in it.
+        std::cerr << "seed is set: enabling virtual-time for a reproducible run\n";
+        config.virtual_time = true;
+        corrected = true;
+    }
+    bool uses_quantum = config.scheduler_type == SchedulerType::RR ||
+        config.scheduler_type == SchedulerType::MLFQ;
+    if (uses_quantum && config.quantum_cycles < 1) {
         std::cerr << "Correcting quantum-cycles to " << DEFAULT_QUANTUM_CYCLES << "\n";
         config.quantum_cycles = DEFAULT_QUANTUM_CYCLES;
         corrected = true;
     }
+    if (config.scheduler_type == SchedulerType::MLFQ) {
+        if (config.mlfq_levels < 1 || config.mlfq_levels > MLFQ_MAX_LEVELS) {
+            std::cerr << "Correcting mlfq-levels from " << config.mlfq_levels << " to " << DEFAULT_MLFQ_LEVELS << " (1 <= n <= " << MLFQ_MAX_LEVELS << ")\n";
+            config.mlfq_levels = DEFAULT_MLFQ_LEVELS;
+            corrected = true;
+        }
+        if (!config.mlfq_quanta.empty() && config.mlfq_quanta.size() != static_cast<size_t>(config.mlfq_levels)) {
+            std::cerr << "mlfq-quanta lists " << config.mlfq_quanta.size() << " quanta for " << config.mlfq_levels << " levels; extending by doubling or truncating\n";
+            corrected = true;
+        }
+        if (config.mlfq_quanta.size() > static_cast<size_t>(config.mlfq_levels)) {
+            config.mlfq_quanta.resize(config.mlfq_levels);
+        }
+        for (size_t level = 0; level < config.mlfq_quanta.size(); ++level) {
+            if (config.mlfq_quanta[level] < 1) {
+                std::cerr << "Correcting mlfq-quanta level " << level << " to " << config.quantum_cycles << "\n";
+                config.mlfq_quanta[level] = config.quantum_cycles;
+                corrected = true;
+            }
+        }
+        // Unlisted levels double the quantum of the level above, starting from quantum-cycles.
+        while (config.mlfq_quanta.size() < static_cast<size_t>(config.mlfq_levels)) {
+            config.mlfq_quanta.push_back(config.mlfq_quanta.empty() ? config.quantum_cycles : config.mlfq_quanta.back() * 2);
+        }
+        if (config.mlfq_boost_ticks < 1) {
+            std::cerr << "Correcting mlfq-boost-ticks to " << DEFAULT_MLFQ_BOOST_TICKS << "\n";
+            config.mlfq_boost_ticks = DEFAULT_MLFQ_BOOST_TICKS;
+            corrected = true;
+        }
+    }
+    if (config.scheduler_type == SchedulerType::CFS) {
+        if (config.cfs_min_granularity < 1) {
+            std::cerr << "Correcting cfs-min-granularity to " << DEFAULT_CFS_MIN_GRANULARITY << "\n";
+            config.cfs_min_granularity = DEFAULT_CFS_MIN_GRANULARITY;
+            corrected = true;
+        }
+        if (config.cfs_latency < config.cfs_min_granularity) {
+            std::cerr << "Correcting cfs-latency from " << config.cfs_latency << " to cfs-min-granularity (" << config.cfs_min_granularity << ")\n";
+            config.cfs_latency = config.cfs_min_granularity;
+            corrected = true;
+        }
+    }
     if (config.batch_process_freq < 1) {
         std::cerr << "Correcting batch-process-freq to " << DEFAULT_BATCH_PROCESS_FREQ << "\n";
         config.batch_process_freq = DEFAULT_BATCH_PROCESS_FREQ;
         corrected = true;
     }
+    if (config.batch_deadline < 0) {
+        std::cerr << "Correcting batch-deadline to 0 (no deadline)\n";
+        config.batch_deadline = 0;
+        corrected = true;
+    }
     if (config.min_ins < 1) {
         std::cerr << "Correcting min-ins to " << DEFAULT_MIN_INS << "\n";
         config.min_ins = DEFAULT_MIN_INS;
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <fstream>
+#include <vector>
 
 enum class SchedulerType {
     FCFS,
@@ -11,17 +12,35 @@ enum class SchedulerType {
     PRIORITY_NONPREEMPTIVE,
     PRIORITY_PREEMPTIVE,
     RR,
+    MLFQ,
+    CFS,
+    EDF,
+    UNKNOWN
+};
+
+enum class InterpreterType {
+    SWITCH,   // Portable switch dispatch
+    THREADED, // Direct-threaded (computed goto) dispatch; falls back to SWITCH if unsupported
     UNKNOWN
 };
 
 // --- Existing Defaults ---
 extern const int DEFAULT_NUM_CPU;
+const int MAX_NUM_CPU = 1024;
 extern const int DEFAULT_QUANTUM_CYCLES;
 extern const int DEFAULT_BATCH_PROCESS_FREQ;
 extern const int DEFAULT_MIN_INS;
 extern const int DEFAULT_MAX_INS;
 extern const int DEFAULT_DELAY_PER_EXEC;
 extern const char* const DEFAULT_SCHEDULER;
+extern const char* const DEFAULT_INTERPRETER;
+extern const int DEFAULT_LOG_CAPACITY;
+extern const int DEFAULT_MLFQ_LEVELS;
+extern const int DEFAULT_MLFQ_BOOST_TICKS;
+const int MLFQ_MAX_LEVELS = 16; // The level is the top bits of the ready-queue key
+extern const int DEFAULT_CFS_LATENCY;
+extern const int DEFAULT_CFS_MIN_GRANULARITY;
+extern const int DEFAULT_DOMAIN_IMBALANCE;
 
 // --- DEFAULTS FOR MEMORY ---
 extern const int DEFAULT_MAX_OVERALL_MEM;
@@ -32,13 +51,32 @@ extern const int DEFAULT_MAX_MEM_PER_PROC;
 
 struct Config {
     int num_cpu = 0;
+    int host_threads = 0; // Host threads running the cores; 0 for one per hardware thread
+    int sched_domains = 1; // Groups of cores with their own run queues and host threads
+    int domain_imbalance = DEFAULT_DOMAIN_IMBALANCE; // Load difference before the balancer moves work between domains
+    bool pin_host_threads = false; // Pin each domain's host threads to its share of the host CPUs (Linux)
     std::string scheduler;
     SchedulerType scheduler_type = SchedulerType::UNKNOWN;
     int quantum_cycles = 0;
+    int mlfq_levels = DEFAULT_MLFQ_LEVELS;
+    std::vector<int> mlfq_quanta; // Per level; defaults to quantum-cycles doubling at each level
+    int mlfq_boost_ticks = DEFAULT_MLFQ_BOOST_TICKS;
+    int cfs_latency = DEFAULT_CFS_LATENCY;                 // Instructions shared by the processes runnable per core
+    int cfs_min_granularity = DEFAULT_CFS_MIN_GRANULARITY; // Shortest slice
     int batch_process_freq = 0;
+    int batch_deadline = 0; // Ticks after creation that generated processes should finish by; 0 for none
     int min_ins = 0;
     int max_ins = 0;
     int delay_per_exec = 0;
+    std::string interpreter = DEFAULT_INTERPRETER;
+    InterpreterType interpreter_type = InterpreterType::SWITCH;
+    int log_capacity = DEFAULT_LOG_CAPACITY; // PRINT records kept in memory per process
+    bool log_spill = false;                  // Append evicted PRINT lines to a file instead of dropping them
+    bool virtual_time = false; // Advance the clock when every core is done with a tick, not every 10 ms
+    // Setting a seed selects deterministic mode: seeded process generation, virtual time,
+    // and cores taking their turn within a tick in a fixed order.
+    bool deterministic = false;
+    unsigned int seed = 0;
 
     // --- MEMORY PARAMETERS ---
     int max_overall_mem = 0;
@@ -0,0 +1,146 @@
+#include "core_pool.h"
+#include "sched_domains.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Where each core is in its run cycle. Only the transitions out of SUSPENDED and
+// RUNNING race; they are made with compare-exchange.
+enum CoreRunState : int {
+    CORE_SUSPENDED,       // Waiting; resume_core() queues it
+    CORE_QUEUED,          // In its domain's 'runnable'
+    CORE_RUNNING,         // A host thread is running its step
+    CORE_RUNNING_RESUMED, // Running, and resumed meanwhile: queue it again afterwards
+    CORE_STOPPED
+};
+
+struct alignas(64) HostDomain {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<int> runnable; // Queued cores, in the order they were resumed
+    int live_cores = 0;       // Cores not stopped yet; guarded by 'mutex'
+};
+
+static std::unique_ptr<HostDomain[]> host_domains;
+static std::unique_ptr<int[]> domain_of_core;
+static std::unique_ptr<std::atomic<int>[]> run_state;
+static std::vector<std::thread> host_threads;
+static CoreStepFunction core_step = nullptr;
+
+static void queue_core(int core_id) {
+    HostDomain& domain = host_domains[domain_of_core[core_id]];
+    {
+        std::lock_guard<std::mutex> lock(domain.mutex);
+        domain.runnable.push_back(core_id);
+    }
+    domain.cv.notify_one();
+}
+
+void resume_core(int core_id) {
+    if (!run_state) return; // No cores started yet
+    std::atomic<int>& state = run_state[core_id];
+    int current = state.load();
+    for (;;) {
+        if (current == CORE_SUSPENDED) {
+            if (state.compare_exchange_weak(current, CORE_QUEUED)) {
+                queue_core(core_id);
+                return;
+            }
+        }
+        else if (current == CORE_RUNNING) {
+            if (state.compare_exchange_weak(current, CORE_RUNNING_RESUMED)) return;
+        }
+        else {
+            return; // Already queued or going to be, or stopped
+        }
+    }
+}
+
+static void host_thread_loop(HostDomain& domain) {
+    for (;;) {
+        int core_id;
+        {
+            std::unique_lock<std::mutex> lock(domain.mutex);
+            domain.cv.wait(lock, [&domain] { return !domain.runnable.empty() || domain.live_cores == 0; });
+            if (domain.runnable.empty()) return;
+            core_id = domain.runnable.front();
+            domain.runnable.pop_front();
+        }
+
+        std::atomic<int>& state = run_state[core_id];
+        state.store(CORE_RUNNING);
+        if (!core_step(core_id)) {
+            state.store(CORE_STOPPED);
+            std::lock_guard<std::mutex> lock(domain.mutex);
+            if (--domain.live_cores == 0) domain.cv.notify_all();
+            continue;
+        }
+
+        int expected = CORE_RUNNING;
+        if (!state.compare_exchange_strong(expected, CORE_SUSPENDED)) {
+            // Resumed during the step. Back of the line, so one busy core cannot hold
+            // a host thread while others wait.
+            state.store(CORE_QUEUED);
+            queue_core(core_id);
+        }
+    }
+}
+
+// Restricts 'thread' to the host CPUs of 'domain': its share of them, or a single CPU
+// when there are more domains than CPUs.
+static void pin_host_thread(std::thread& thread, int domain, int domain_count) {
+#ifdef __linux__
+    int host_cpus = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    int first = domain_first(domain, host_cpus, domain_count);
+    int end = std::max(domain_first(domain + 1, host_cpus, domain_count), first + 1);
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu = first; cpu < end; ++cpu) CPU_SET(cpu % host_cpus, &cpus);
+    int error = pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus);
+    if (error != 0) {
+        std::cerr << "Could not pin host thread of domain " << domain << " (error " << error << ")\n";
+    }
+#else
+    (void)thread;
+    (void)domain;
+    (void)domain_count;
+#endif
+}
+
+void start_core_pool(int core_count, int domain_count, int threads_per_domain, bool pin,
+                     CoreStepFunction step) {
+    core_step = step;
+    host_domains.reset(new HostDomain[domain_count]);
+    domain_of_core.reset(new int[core_count]);
+    run_state.reset(new std::atomic<int>[core_count]);
+    for (int core = 0; core < core_count; ++core) {
+        int domain = domain_of(core, core_count, domain_count);
+        domain_of_core[core] = domain;
+        run_state[core] = CORE_QUEUED;
+        host_domains[domain].runnable.push_back(core);
+        host_domains[domain].live_cores++;
+    }
+    for (int domain = 0; domain < domain_count; ++domain) {
+        for (int i = 0; i < threads_per_domain; ++i) {
+            host_threads.emplace_back(host_thread_loop, std::ref(host_domains[domain]));
+            if (pin) pin_host_thread(host_threads.back(), domain, domain_count);
+        }
+    }
+}
+
+void join_core_pool() {
+    for (auto& thread : host_threads) {
+        if (thread.joinable()) thread.join();
+    }
+    host_threads.clear();
+}
@@ -0,0 +1,33 @@
+#ifndef CORE_POOL_H
+#define CORE_POOL_H
+
+// M:N execution of the emulated cores. A core is a resumable state machine (see
+// cpu_core.cpp): its step function runs until the core has to wait for a tick or for
+// work, records where it stopped and returns. A fixed pool of host threads runs the
+// steps of whichever cores have been resumed, so num-cpu is not limited by how many
+// host threads the machine can afford.
+//
+// Each scheduling domain (sched_domains.h) has its own host threads and its own queue
+// of resumed cores, so domains do not contend on one pool lock. With pinning the
+// domain's host threads are restricted to its share of the host CPUs, keeping its
+// cores, and the processes they run, on the same part of the machine.
+//
+// A core runs on at most one host thread at a time. A core resumed while its step is
+// still running is queued again once the step returns, so a wakeup is never lost;
+// steps must therefore tolerate being resumed before their wait is over.
+
+// Runs one step of 'core_id'. Returns false once the core has stopped for good.
+using CoreStepFunction = bool (*)(int core_id);
+
+// Starts 'threads_per_domain' host threads for each of 'domain_count' domains of
+// 'core_count' cores, all cores initially resumed. 'pin' sets the threads' host CPU
+// affinity where the platform supports it (Linux).
+void start_core_pool(int core_count, int domain_count, int threads_per_domain, bool pin,
+                     CoreStepFunction step);
+// Queues 'core_id' to run its next step. Safe to call from any thread, any number of
+// times; resuming a queued or stopped core does nothing.
+void resume_core(int core_id);
+// Waits for every core to stop, then for the host threads to exit.
+void join_core_pool();
+
+#endif // CORE_POOL_H
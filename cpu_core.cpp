@@ -3,104 +3,219 @@
 #include "scheduler_utils.h"
 #include "instructions.h"
 #include "mem_manager.h"
-#include <thread>
-#include <chrono>
+#include "core_pool.h"
 #include <iostream>
+#include <memory>
+
+// Where a core's step picks up when the core pool resumes it.
+enum class CorePhase {
+    DISPATCH, // Take the next process, or park
+    PARKED,   // Parked in run_queues until woken for work
+    WAITING,  // Waiting for 'wait_tick', then on to 'after_wait'
+    RUN,      // Top of the instruction loop
+    EXECUTE,  // Run the next instruction
+    CHECK     // The instruction and its delay are over: keep going or yield
+};
+
+// Everything a core keeps between steps. The step itself holds nothing across a wait.
+struct CoreContext {
+    CorePhase phase = CorePhase::DISPATCH;
+    CorePhase after_wait = CorePhase::DISPATCH;
+    uint64_t wait_tick = 0;
+    Process* process = nullptr;
+    int instructions_executed_in_quantum = 0;
+    PinnedView pinned; // Reused for every slice this core runs
+};
+
+static std::unique_ptr<CoreContext[]> core_contexts;
+
+static void wait_then(CoreContext& core, uint64_t tick, CorePhase next) {
+    core.wait_tick = tick;
+    core.after_wait = next;
+    core.phase = CorePhase::WAITING;
+}
+
+static void begin_slice(int core_id, CoreContext& core) {
+    Process* process = core.process;
+    process->assigned_core = core_id;
+    process->state = ProcessState::RUNNING;
+    if(process->start_time == NO_TIMESTAMP) process->start_time = current_timestamp_id();
+    core_busy[core_id] = true;
+
+    core.instructions_executed_in_quantum = 0;
+    process->paged_in = false;
+
+    // Decode any instructions added since the process last ran.
+    compile_program(process);
+
+    // One manager lock acquisition pins the resident pages for the whole slice.
+    global_mem_manager->pinResidentPages(process->id, core.pinned);
+    process->pinned_pages = &core.pinned;
+}
+
+template <typename Policy>
+static void end_slice(int core_id, CoreContext& core) {
+    Process* process = core.process;
+    core.process = nullptr;
+
+    // Variables cached in the register file go back to emulated memory
+    // before the process leaves the core.
+    if (process->state != ProcessState::CRASHED) {
+        flush_registers(process);
+    }
+    process->pinned_pages = nullptr;
+    global_mem_manager->unpinResidentPages(core.pinned);
+
+    core_busy[core_id] = false;
+    process->last_core = core_id;
+    Policy::on_yield(process, core.instructions_executed_in_quantum);
+
+    // The process's turn is over, figure out where it goes next.
+    bool finished = process->state == ProcessState::CRASHED ||
+        (process->state == ProcessState::RUNNING &&
+         process->program_counter >= static_cast<int>(process->program.code.size()));
+
+    if (!finished) {
+        // A sleeper is filed in the timer wheel and clock_thread requeues it when its
+        // tick comes. Otherwise (quantum expired, preempted, or the sleep is already
+        // over) it goes straight back to a run queue. Either way another core may
+        // pick it up right away, so it is not touched here afterwards.
+        bool sleeping = process->state == ProcessState::WAITING &&
+            sleep_timers.schedule(process, process->sleep_until_tick);
+        if (!sleeping) {
+            process->state = ProcessState::READY;
+            run_queues.enqueue(process, core_id);
+        }
+    }
+    else {
+        std::lock_guard<std::mutex> lock(queue_mutex);
 
-void cpu_core_worker(int core_id) {
-    while (system_running) {
-        Process* process = nullptr;
-
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex);
-            queue_cv.wait(lock, [] { return !ready_queue.empty() || !system_running; });
+        if (process->state == ProcessState::RUNNING) {
+            // --- The process has completed all its instructions. ---
+            process->state = ProcessState::FINISHED;
+            process->finished = true;
+            process->end_time = current_timestamp_id();
+            process->end_tick = cpu_ticks.load();
 
-            if (!system_running) break;
+            process->program_counter = process->instructions.size();
 
-            process = select_process();
-            if (process) {
-                process->assigned_core = core_id;
-                process->state = ProcessState::RUNNING;
-                if(process->start_time.empty()) process->start_time = get_timestamp();
-                core_busy[core_id] = true;
-            }
+            // comment out first, might be messing with memory allocation.
+            // global_mem_manager->removeProcess(process->id);
         }
-        
-        if (process) {
-            int instructions_executed_in_quantum = 0;
-
-            while (system_running && process->program_counter < process->instructions.size()) {
-
-                if (global_config.delay_per_exec == 0) {
-                    uint64_t current_tick = cpu_ticks.load();
-                    while (system_running && cpu_ticks.load() <= current_tick) {                      
-                        std::this_thread::sleep_for(std::chrono::nanoseconds(100));
-                    }
+        else {
+            process->finished = true;
+            process->end_time = current_timestamp_id();
+            process->end_tick = cpu_ticks.load();
+            global_mem_manager->removeProcess(process->id);
+        }
+    }
+}
+
+// Runs core 'core_id' until it has to wait, as a state machine over CorePhase.
+// Instantiated per scheduling policy so the per-instruction checks are resolved at
+// compile time. Returns false once the core has stopped.
+template <typename Policy>
+static bool step_core(int core_id) {
+    CoreContext& core = core_contexts[core_id];
+    for (;;) {
+        switch (core.phase) {
+        case CorePhase::WAITING:
+            if (!core_wait_for_tick(core_id, core.wait_tick)) return true;
+            core.phase = core.after_wait;
+            break;
+
+        case CorePhase::PARKED:
+            run_queues.unpark(core_id);
+            core.phase = CorePhase::DISPATCH;
+            break;
+
+        case CorePhase::DISPATCH: {
+            if (!system_running) {
+                core_leave_tick_barrier(core_id);
+                return false;
+            }
+            // Dispatch takes only run-queue locks; with nothing to run the core parks.
+            // The core joins the tick barrier first so a virtual-time tick cannot end
+            // between taking a process and its first instruction.
+            bool joined = core_join_tick_barrier(core_id);
+            if (joined && global_config.deterministic) {
+                // A new member's first turn is in the next tick.
+                wait_then(core, cpu_ticks.load() + 1, CorePhase::DISPATCH);
+                break;
+            }
+            core.process = select_process(core_id);
+            if (!core.process) {
+                if (global_config.deterministic) {
+                    // Stay in the barrier and look again on this core's turn next tick.
+                    wait_then(core, cpu_ticks.load() + 1, CorePhase::DISPATCH);
+                    break;
                 }
-
-                execute_instruction(process);
-
-                if (global_config.delay_per_exec > 0) {
-                    uint64_t start_tick = cpu_ticks.load();
-                    uint64_t end_tick = start_tick + global_config.delay_per_exec;
-                    while (system_running && cpu_ticks.load() < end_tick) {
-                        std::this_thread::sleep_for(std::chrono::nanoseconds(100));
-                    }
+                core_leave_tick_barrier(core_id);
+                if (run_queues.park(core_id)) {
+                    core.phase = CorePhase::PARKED;
+                    return true;
                 }
+                break; // Work arrived meanwhile
+            }
+            begin_slice(core_id, core);
+            core.phase = CorePhase::RUN;
+            break;
+        }
 
-                instructions_executed_in_quantum++;
-                std::this_thread::sleep_for(std::chrono::milliseconds(global_config.delay_per_exec));
+        case CorePhase::RUN:
+            if (!system_running || core.process->program_counter >= static_cast<int>(core.process->program.code.size())) {
+                end_slice<Policy>(core_id, core);
+                core.phase = CorePhase::DISPATCH;
+            }
+            else if (global_config.delay_per_exec == 0) {
+                // Without a delay, each instruction waits for the next tick.
+                wait_then(core, cpu_ticks.load() + 1, CorePhase::EXECUTE);
+            }
+            else {
+                core.phase = CorePhase::EXECUTE;
+            }
+            break;
 
-                if (process->state != ProcessState::RUNNING) {
-                    // The process state changed due to SLEEP, CRASH, or a data page fault.
-                    // Break the loop to yield the CPU.
-                    break;
-                }
+        case CorePhase::EXECUTE: {
+            if (!system_running) {
+                end_slice<Policy>(core_id, core);
+                core.phase = CorePhase::DISPATCH;
+                break;
+            }
+            execute_instruction(core.process);
+            core.instructions_executed_in_quantum++;
 
-                // Check if the quantum has expired.
-                if (should_yield(process, instructions_executed_in_quantum, should_preempt(), uses_quantum())) {
-                    break;
-                }
+            // With a delay, the core stays busy for delay-per-exec ticks after it.
+            if (global_config.delay_per_exec > 0) {
+                wait_then(core, cpu_ticks.load() + global_config.delay_per_exec, CorePhase::CHECK);
+            }
+            else {
+                core.phase = CorePhase::CHECK;
             }
+            break;
+        }
 
-            core_busy[core_id] = false;
-            process->last_core = core_id;
-
-            {
-                std::lock_guard<std::mutex> lock(queue_mutex);
-
-                // The process's turn is over, figure out where it goes next.
-                if (process->state == ProcessState::RUNNING) {
-                    // It was still running (quantum expired or finished).
-                    if (process->program_counter >= process->instructions.size()) {
-                        // --- The process has completed all its instructions. ---
-                        process->state = ProcessState::FINISHED;
-                        process->finished = true;
-                        process->end_time = get_timestamp();
-         
-                        process->program_counter = process->instructions.size();
-
-                        // comment out first, might be messing with memory allocation. 
-                        // global_mem_manager->removeProcess(process->id);
-
-                    }
-                    else {
-                        // Quantum expired, but the process is not finished. Put it back on the ready queue.
-                        process->state = ProcessState::READY;
-                        ready_queue.push(process);
-                    }
-                }
-                else if (process->state == ProcessState::WAITING) {
-                    process->state = ProcessState::READY;
-                    ready_queue.push(process);
-                }
-                else if (process->state == ProcessState::CRASHED) {
-                    process->finished = true;
-                    process->end_time = get_timestamp();
-                    global_mem_manager->removeProcess(process->id);
-                }
-                queue_cv.notify_all();
+        case CorePhase::CHECK:
+            // SLEEP, CRASH or a data page fault changed the state, or the quantum
+            // expired, or a better process is waiting: yield the CPU.
+            if (core.process->state != ProcessState::RUNNING ||
+                should_yield<Policy>(core.process, core.instructions_executed_in_quantum)) {
+                end_slice<Policy>(core_id, core);
+                core.phase = CorePhase::DISPATCH;
+            }
+            else {
+                core.phase = CorePhase::RUN;
             }
+            break;
         }
     }
-}
\ No newline at end of file
+}
+
+void run_cpu_cores(int core_count, int domain_count, int threads_per_domain) {
+    core_contexts.reset(new CoreContext[core_count]);
+    init_tick_barrier(core_count);
+    CoreStepFunction step = dispatch_policy(global_config.scheduler_type, [](auto policy) {
+        return static_cast<CoreStepFunction>(&step_core<decltype(policy)>);
+    });
+    start_core_pool(core_count, domain_count, threads_per_domain, global_config.pin_host_threads, step);
+}
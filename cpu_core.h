@@ -1,7 +1,9 @@
 #ifndef CPU_CORE_H
 #define CPU_CORE_H
 
-// The main function for a CPU core thread.
-void cpu_core_worker(int core_id);
+// Starts 'core_count' emulated CPU cores in 'domain_count' scheduling domains, each
+// run by 'threads_per_domain' host threads (see core_pool.h), and returns.
+// join_core_pool() waits for them after shutdown.
+void run_cpu_cores(int core_count, int domain_count, int threads_per_domain);
 
-#endif // CPU_CORE_H
\ No newline at end of file
+#endif // CPU_CORE_H
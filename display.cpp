@@ -59,7 +59,7 @@ void generate_system_report(std::ostream& output_stream) {
     for (const auto& p : process_list) {
         if (!p->finished) {
             output_stream << std::left << std::setw(12) << p->name
-                << std::setw(25) << p->start_time
+                << std::setw(25) << format_timestamp(p->start_time)
                 << "Core: " << std::left << std::setw(5) << p->assigned_core
                 << p->program_counter << " / " << p->instructions.size() << "\n";
         }
@@ -75,12 +75,13 @@ void generate_system_report(std::ostream& output_stream) {
     }
 
     std::sort(finished.begin(), finished.end(), [](Process* a, Process* b) {
-        return a->end_time < b->end_time;
+        if (a->end_time != b->end_time) return a->end_time < b->end_time;
+        return a->id < b->id;
         });
 
     for (const auto& p : finished) {
         output_stream << std::left << std::setw(12) << p->name
-            << std::setw(25) << p->end_time
+            << std::setw(25) << format_timestamp(p->end_time)
             << "Core: " << std::setw(5) << p->last_core;
             if (p->state == ProcessState::CRASHED) {
                 output_stream << std::left << std::setw(10) << "Crashed";
@@ -89,7 +90,38 @@ void generate_system_report(std::ostream& output_stream) {
                 output_stream << std::left << std::setw(10) << "Finished";
             }
             output_stream << std::setw(14) << (std::to_string(p->program_counter) + " / " + std::to_string(p->instructions.size()))
-                << " Priority: " << p->priority << "\n";
+                << " Priority: " << p->priority;
+            if (p->deadline_tick != NO_DEADLINE && p->state != ProcessState::CRASHED) {
+                output_stream << (p->end_tick <= p->deadline_tick ? "  Deadline met" : "  Deadline missed");
+            }
+            output_stream << "\n";
+    }
+
+    // Deadline outcomes of the processes that were given one. A process still running
+    // past its deadline already counts as a miss.
+    int met = 0;
+    int missed = 0;
+    int overdue = 0;
+    uint64_t now = cpu_ticks.load();
+    for (const auto& p : process_list) {
+        if (p->deadline_tick == NO_DEADLINE || p->state == ProcessState::CRASHED) continue;
+        if (p->finished) {
+            if (p->end_tick <= p->deadline_tick) met++;
+            else missed++;
+        }
+        else if (now > p->deadline_tick) {
+            overdue++;
+        }
+    }
+    int decided = met + missed + overdue;
+    if (decided > 0) {
+        std::ios::fmtflags flags = output_stream.flags();
+        std::streamsize precision = output_stream.precision();
+        output_stream << "\nDeadlines met: " << met << ", missed: " << missed + overdue
+            << " (" << overdue << " still running), miss rate: "
+            << std::fixed << std::setprecision(1) << (100.0 * (missed + overdue) / decided) << "%\n";
+        output_stream.flags(flags);
+        output_stream.precision(precision);
     }
 
     output_stream << "---------------------------------------------------------\n";
@@ -108,12 +140,16 @@ void display_process_view(Process* process) {
     
     // --- Logs Section ---
     std::cout << "\nLogs:\n";
+    uint64_t evicted = process->logs.evicted_lines();
+    if (evicted > 0) {
+        std::cout << "(" << evicted << " earlier lines "
+            << (process->logs.spilled() ? std::string("written to ") + LOG_SPILL_FILENAME : std::string("dropped"))
+            << ")\n";
+    }
     if (process->logs.empty()) {
-        std::cout << "(No output generated yet)\n";
+        if (evicted == 0) std::cout << "(No output generated yet)\n";
     } else {
-        for(const auto& log_line : process->logs) {
-            std::cout << log_line << "\n";
-        }
+        process->logs.print(std::cout, process->program.names);
     }
 
     // --- Status Section ---
@@ -221,5 +257,10 @@ void show_vmstat() {
     std::cout << std::left << std::setw(25) << "Active CPU ticks:" << active_ticks << "\n";
     std::cout << std::left << std::setw(25) << "Total CPU ticks:" << total_ticks << "\n";
     std::cout << std::left << std::setw(25) << "Pages paged in:" << global_mem_manager->getPageInCount() << "\n";
-    std::cout << std::left << std::setw(25) << "Pages paged out:" << global_mem_manager->getPageOutCount() << "\n\n";
+    std::cout << std::left << std::setw(25) << "Pages paged out:" << global_mem_manager->getPageOutCount() << "\n";
+    std::cout << std::left << std::setw(25) << "TLB hits:" << global_mem_manager->getTlbHitCount() << "\n";
+    std::cout << std::left << std::setw(25) << "TLB misses:" << global_mem_manager->getTlbMissCount() << "\n";
+    std::cout << std::left << std::setw(25) << "Core wakeups:" << run_queues.wakeups() << "\n";
+    std::cout << std::left << std::setw(25) << "Spurious wakeups:" << run_queues.spurious_wakeups() << "\n";
+    std::cout << std::left << std::setw(25) << "Domain migrations:" << run_queues.domain_migrations() << "\n\n";
 }
@@ -2,310 +2,450 @@
 #include "shared_globals.h"
 #include "mem_manager.h"
 #include <iostream>
-#include <sstream>
 #include <cstdint>
 #include <algorithm>
 #include <limits>
 
-bool is_number(const std::string& s) {
-    if (s.empty()) return false;
-    size_t start_idx = 0;
-    if (s[0] == '-') {
-        start_idx = 1;
-        if (s.length() == 1) return false;
+// Process memory accessors: go through the core's pinned view of the resident pages
+// and only take the MemoryManager lock when the page is not pinned (e.g. a page fault).
+// The page is pinned on the way, so that happens once per page and slice.
+// A page fault serviced on the way is recorded for the scheduler (see paged_in).
+static bool load_word(Process* process, uint16_t address, uint16_t& value) {
+    if (process->pinned_pages && global_mem_manager->readPinned(*process->pinned_pages, address, value)) {
+        return true;
     }
-    return std::all_of(s.begin() + start_idx, s.end(), ::isdigit);
+    bool faulted = false;
+    bool ok = global_mem_manager->readMemory(process->id, address, value, &faulted, process->pinned_pages);
+    if (faulted) process->paged_in = true;
+    return ok;
 }
 
-bool parse_hex_address(const std::string& s, uint16_t& out_address) {
-    if (s.empty()) return false;
-    try {
-        // Use std::stoul which can handle "0x" prefixes automatically.
-        // The third argument '16' specifies the base (hexadecimal).
-        unsigned long value = std::stoul(s, nullptr, 16);
-        if (value > std::numeric_limits<uint16_t>::max()) {
-            return false; // Value is too large for a uint16_t address
-        }
-        out_address = static_cast<uint16_t>(value);
+static bool store_word(Process* process, uint16_t address, uint16_t value) {
+    if (process->pinned_pages && global_mem_manager->writePinned(*process->pinned_pages, address, value)) {
         return true;
     }
-    catch (const std::invalid_argument& e) {
-        return false; // Not a valid number
-    }
-    catch (const std::out_of_range& e) {
-        return false; // Out of range for unsigned long
-    }
+    bool faulted = false;
+    bool ok = global_mem_manager->writeMemory(process->id, address, value, &faulted, process->pinned_pages);
+    if (faulted) process->paged_in = true;
+    return ok;
 }
 
-uint16_t get_variable_address(Process* process, const std::string& var_name, bool create_if_new) {
+uint16_t get_variable_address(Process* process, const Operand& var, bool create_if_new) {
+    int8_t slot = process->symbol_slots[var.value];
 
-    if (process->variable_data_offsets.count(var_name)) {
-        return process->variable_data_offsets[var_name];
+    if (slot != UNDECLARED_SLOT) {
+        return static_cast<uint16_t>(slot * sizeof(uint16_t));
     } 
     else if (create_if_new) {
         // Variable is new, assign it a new offset in the data segment.
         uint16_t new_offset = process->next_available_variable_offset;
 
-        /* For debugging purposes, we can print the variable name and address.
-        std::cout << "[DEBUG] Attempting to declare " << var_name
-            << " at address " << new_absolute_addr
-            << " (used: " << (int)(new_offset + sizeof(uint16_t))
-            << " / " << (int)(process->memory_required - data_segment_start) << ")\n";
-        */
-
         if (new_offset + sizeof(uint16_t) > SYMBOL_TABLE_SIZE) {
             std::cerr << "[ERROR] P" << process->id << ": Symbol table full. Cannot declare '"
-                << var_name << "'. Max 32 variables. Instruction ignored.\n";
-            // We return a special value or handle it, but don't crash the process
-            // as per the requirement to "ignore" the instruction.
-            // For simplicity, we can let the caller check for a special return,
-            // but here we'll just log and return an invalid address.
+                << process->program.names[var.value] << "'. Max 32 variables. Instruction ignored.\n";
+            // We don't crash the process as per the requirement to "ignore" the instruction.
             return std::numeric_limits<uint16_t>::max(); // Indicates an error
         }
 
-        process->variable_data_offsets[var_name] = new_offset;
+        process->symbol_slots[var.value] = static_cast<int8_t>(new_offset / sizeof(uint16_t));
         process->next_available_variable_offset += sizeof(uint16_t);
 
         return new_offset; // The address is the offset itself.
     }
     
     // If we get here, the variable was not found and we were not allowed to create it.
-    std::cerr << "[ERROR] P" << process->id << ": SEGFAULT - Use of undeclared variable '" << var_name << "'.\n";
+    std::cerr << "[ERROR] P" << process->id << ": SEGFAULT - Use of undeclared variable '"
+        << process->program.names[var.value] << "'.\n";
     process->state = ProcessState::CRASHED;
     return 0;
 }
 
-uint16_t read_variable_value(Process* process, const std::string& arg) {
-    uint16_t value = 0;
-    if (is_number(arg)) {
-        try {
-            long val_long = std::stol(arg);
-            if (val_long < 0 || val_long > std::numeric_limits<uint16_t>::max()) {
-                process->state = ProcessState::CRASHED; return 0;
-            }
-            return static_cast<uint16_t>(val_long);
-        }
-        catch (...) { process->state = ProcessState::CRASHED; return 0; }
+// Reads a variable through the register file, loading it from the symbol table on a miss.
+static uint16_t read_variable(Process* process, const Operand& var) {
+    // On a read, the variable must already exist. `create_if_new` is false.
+    uint16_t var_addr = get_variable_address(process, var, false);
+    if (process->state == ProcessState::CRASHED) return 0;
+
+    RegisterFile& regs = process->registers;
+    int slot = var_addr / sizeof(uint16_t);
+    if (regs.loaded & (1u << slot)) {
+        return regs.values[slot];
     }
-    else {
-        // On a read, the variable must already exist. `create_if_new` is false.
-        uint16_t var_addr = get_variable_address(process, arg, false);
-        if (process->state == ProcessState::CRASHED) return 0;
-
-        // The MemoryManager will handle the data page fault if necessary.
-        if (!global_mem_manager->readMemory(process->id, var_addr, value)) {
-            process->had_page_fault = true;
-            process->faulting_address = var_addr;
-            return 0;
-        }
+
+    // The MemoryManager will handle the data page fault if necessary.
+    uint16_t value = 0;
+    if (!load_word(process, var_addr, value)) {
+        process->had_page_fault = true;
+        process->faulting_address = var_addr;
+        return 0;
     }
+    regs.values[slot] = value;
+    regs.loaded |= (1u << slot);
     return value;
 }
 
-void write_variable_value(Process* process, const std::string& dest_var_name, uint16_t value) {
+uint16_t read_variable_value(Process* process, const Operand& arg) {
+    if (arg.kind == OperandKind::IMMEDIATE) {
+        return static_cast<uint16_t>(arg.value);
+    }
+    else if (arg.kind != OperandKind::VARIABLE) {
+        // The literal did not fit in a uint16 when the program was compiled.
+        process->state = ProcessState::CRASHED; return 0;
+    }
+    return read_variable(process, arg);
+}
+
+void write_variable_value(Process* process, const Operand& dest_var, uint16_t value) {
     // On a write (like from DECLARE or ADD), we can create the variable. `create_if_new` is true.
-    uint16_t var_addr = get_variable_address(process, dest_var_name, true);
+    uint16_t var_addr = get_variable_address(process, dest_var, true);
     if (process->state == ProcessState::CRASHED) return;
 
     if (var_addr == std::numeric_limits<uint16_t>::max()) {
         return;
     }
 
-    // The MemoryManager will handle the data page fault if necessary.
-    if (!global_mem_manager->writeMemory(process->id, var_addr, value)) {
-        process->had_page_fault = true;
-        process->faulting_address = var_addr;
+    // The value stays in the register file until flush_registers() writes it back.
+    RegisterFile& regs = process->registers;
+    int slot = var_addr / sizeof(uint16_t);
+    regs.values[slot] = value;
+    regs.loaded |= (1u << slot);
+    regs.dirty |= (1u << slot);
+}
+
+// ADD clamps at the uint16 maximum; SUBTRACT wraps around like uint16 arithmetic.
+static inline uint16_t add_saturating(uint16_t lhs, uint16_t rhs) {
+    uint32_t sum = static_cast<uint32_t>(lhs) + rhs;
+    return static_cast<uint16_t>(std::min(sum, static_cast<uint32_t>(std::numeric_limits<uint16_t>::max())));
+}
+
+static inline uint16_t subtract_wrapping(uint16_t lhs, uint16_t rhs) {
+    return static_cast<uint16_t>(lhs - rhs);
+}
+
+// Reads an arithmetic operand whose kind was fixed when the program was compiled,
+// so the specialized handlers below carry no run-time kind test.
+template <OperandKind Kind>
+static inline uint16_t read_operand(Process* process, const Operand& arg) {
+    static_assert(Kind == OperandKind::IMMEDIATE || Kind == OperandKind::VARIABLE,
+                  "only immediate and variable operands are specialized");
+    if constexpr (Kind == OperandKind::IMMEDIATE) {
+        return static_cast<uint16_t>(arg.value);
+    }
+    else {
+        return read_variable(process, arg);
     }
 }
 
-void execute_instruction(Process* process) {
-    if (process->state == ProcessState::CRASHED) return;
-    if (!process->for_stack.empty()) {
-        ForContext& ctx = process->for_stack.top();
-        if (ctx.current_repeat >= ctx.repeat_count) {
-            process->for_stack.pop();
-            process->program_counter++;
-            return;
+// ADD/SUBTRACT variants selected by compile_program from the operand kinds
+// (OpCode::ADD_VAR_VAR etc.). The generic handle_add/handle_subtract remain for
+// operands that failed to decode.
+template <OperandKind Lhs, OperandKind Rhs>
+static void handle_add_specialized(Process* process, const DecodedInstruction& instr) {
+    uint16_t val1 = read_operand<Lhs>(process, instr.src1);
+    if (Lhs == OperandKind::VARIABLE && process->state == ProcessState::CRASHED) return;
+    uint16_t val2 = read_operand<Rhs>(process, instr.src2);
+    if (Rhs == OperandKind::VARIABLE && process->state == ProcessState::CRASHED) return;
+    write_variable_value(process, instr.dest, add_saturating(val1, val2));
+}
+
+template <OperandKind Lhs, OperandKind Rhs>
+static void handle_subtract_specialized(Process* process, const DecodedInstruction& instr) {
+    uint16_t val1 = read_operand<Lhs>(process, instr.src1);
+    if (Lhs == OperandKind::VARIABLE && process->state == ProcessState::CRASHED) return;
+    uint16_t val2 = read_operand<Rhs>(process, instr.src2);
+    if (Rhs == OperandKind::VARIABLE && process->state == ProcessState::CRASHED) return;
+    write_variable_value(process, instr.dest, subtract_wrapping(val1, val2));
+}
+
+// Returns the register slots overlapped by a 2-byte access at 'address'.
+static uint32_t aliased_slots(uint16_t address) {
+    uint32_t mask = 0;
+    for (uint32_t addr = address; addr < address + sizeof(uint16_t); ++addr) {
+        if (addr < SYMBOL_TABLE_SIZE) mask |= 1u << (addr / sizeof(uint16_t));
+    }
+    return mask;
+}
+
+void flush_registers(Process* process, uint32_t slots) {
+    RegisterFile& regs = process->registers;
+    uint32_t pending = regs.dirty & slots;
+    for (int slot = 0; pending != 0; ++slot, pending >>= 1) {
+        if (!(pending & 1u)) continue;
+        uint16_t var_addr = static_cast<uint16_t>(slot * sizeof(uint16_t));
+        // A failed write-back leaves the slot dirty so the next flush retries it.
+        if (store_word(process, var_addr, regs.values[slot])) {
+            regs.dirty &= ~(1u << slot);
         }
-        if (ctx.current_instruction_index >= ctx.instructions.size()) {
+    }
+}
+
+// Returns the instruction the process executes next, first handling FOR loops that
+// wrapped or completed. Completing a loop takes a step of its own: 'consumed_step' is
+// set and nullptr returned. nullptr without a consumed step means the program ended.
+static const DecodedInstruction* fetch_instruction(Process* process, bool& consumed_step) {
+    consumed_step = false;
+    if (!process->for_stack.empty()) {
+        ForContext& ctx = process->for_stack.back();
+        if (ctx.current_instruction_index >= ctx.body->size()) {
             ctx.current_instruction_index = 0;
             ctx.current_repeat++;
         }
-        if (ctx.current_repeat < ctx.repeat_count && ctx.current_instruction_index < ctx.instructions.size()) {
-            const Instruction& loop_instr = ctx.instructions[ctx.current_instruction_index++];
-            dispatch_instruction(process, loop_instr);
-            return;
+        if (ctx.current_repeat >= ctx.repeat_count) {
+            // The loop is done. Its FOR instruction completes now.
+            process->for_stack.pop_back();
+            if (process->for_stack.empty()) process->program_counter++;
+            else process->for_stack.back().current_instruction_index++;
+            consumed_step = true;
+            return nullptr;
+        }
+        return &(*ctx.body)[ctx.current_instruction_index];
+    }
+    if (process->program_counter >= static_cast<int>(process->program.code.size())) return nullptr;
+    return &process->program.code[process->program_counter];
+}
+
+// Moves past an executed instruction. Only advance if no page fault occurred. A FOR
+// that entered its loop advances when the loop completes; the faulting instruction
+// is re-executed on retry.
+static void retire_instruction(Process* process, size_t loop_depth) {
+    if (process->had_page_fault || process->for_stack.size() > loop_depth) return;
+    if (loop_depth == 0) process->program_counter++;
+    else process->for_stack.back().current_instruction_index++;
+}
+
+// Portable backend: one switch per instruction (see dispatch_instruction).
+static int run_switch(Process* process, int max_steps) {
+    ProcessState entry_state = process->state;
+    int retired = 0;
+    while (retired < max_steps) {
+        bool consumed_step;
+        const DecodedInstruction* instr = fetch_instruction(process, consumed_step);
+        if (!instr) {
+            if (!consumed_step) break;
+            retired++;
+            continue;
         }
-        return;
+
+        size_t loop_depth = process->for_stack.size();
+        process->had_page_fault = false;
+        dispatch_instruction(process, *instr);
+        retire_instruction(process, loop_depth);
+        retired++;
+
+        if (process->state != entry_state || process->had_page_fault) break;
     }
-    if (process->program_counter >= process->instructions.size()) return;
-    const Instruction& current_instruction = process->instructions[process->program_counter];
-    process->had_page_fault = false;
-    dispatch_instruction(process, current_instruction);
-
-    // Only advance if no page fault occurred
-    if (!process->had_page_fault && current_instruction.opcode != "FOR") {
-        process->program_counter++;
+    return retired;
+}
+
+// Direct-threaded backend: each handler jumps straight to the next instruction's
+// handler through a table of label addresses (GCC/Clang "labels as values"), so
+// there is one indirect branch per opcode site instead of a shared switch.
+static int run_threaded(Process* process, int max_steps) {
+#if defined(__GNUC__) || defined(__clang__)
+    // Indexed by OpCode; keep in the same order as the enum.
+    static void* const handlers[] = {
+        &&op_print, &&op_declare, &&op_add, &&op_subtract,
+        &&op_sleep, &&op_for, &&op_read, &&op_write,
+        &&op_add_vv, &&op_add_vi, &&op_add_iv, &&op_add_ii,
+        &&op_sub_vv, &&op_sub_vi, &&op_sub_iv, &&op_sub_ii,
+        &&op_invalid
+    };
+
+    ProcessState entry_state = process->state;
+    int retired = 0;
+    const DecodedInstruction* instr = nullptr;
+    size_t loop_depth = 0;
+    bool consumed_step = false;
+
+#define THREADED_DISPATCH()                                                   \
+    for (;;) {                                                                \
+        if (retired >= max_steps) return retired;                             \
+        instr = fetch_instruction(process, consumed_step);                    \
+        if (instr) break;                                                     \
+        if (!consumed_step) return retired;                                   \
+        retired++;                                                            \
+    }                                                                         \
+    loop_depth = process->for_stack.size();                                   \
+    process->had_page_fault = false;                                          \
+    goto *handlers[static_cast<uint8_t>(instr->op)]
+
+#define THREADED_NEXT()                                                       \
+    retire_instruction(process, loop_depth);                                  \
+    retired++;                                                                \
+    if (process->state != entry_state || process->had_page_fault) return retired; \
+    THREADED_DISPATCH()
+
+    THREADED_DISPATCH();
+
+op_print:    handle_print(process, *instr);    THREADED_NEXT();
+op_declare:  handle_declare(process, *instr);  THREADED_NEXT();
+op_add:      handle_add(process, *instr);      THREADED_NEXT();
+op_subtract: handle_subtract(process, *instr); THREADED_NEXT();
+op_sleep:    handle_sleep(process, *instr);    THREADED_NEXT();
+op_for:      handle_for(process, *instr);      THREADED_NEXT();
+op_read:     handle_read(process, *instr);     THREADED_NEXT();
+op_write:    handle_write(process, *instr);    THREADED_NEXT();
+op_add_vv:   handle_add_specialized<OperandKind::VARIABLE, OperandKind::VARIABLE>(process, *instr);       THREADED_NEXT();
+op_add_vi:   handle_add_specialized<OperandKind::VARIABLE, OperandKind::IMMEDIATE>(process, *instr);      THREADED_NEXT();
+op_add_iv:   handle_add_specialized<OperandKind::IMMEDIATE, OperandKind::VARIABLE>(process, *instr);      THREADED_NEXT();
+op_add_ii:   handle_add_specialized<OperandKind::IMMEDIATE, OperandKind::IMMEDIATE>(process, *instr);     THREADED_NEXT();
+op_sub_vv:   handle_subtract_specialized<OperandKind::VARIABLE, OperandKind::VARIABLE>(process, *instr);  THREADED_NEXT();
+op_sub_vi:   handle_subtract_specialized<OperandKind::VARIABLE, OperandKind::IMMEDIATE>(process, *instr); THREADED_NEXT();
+op_sub_iv:   handle_subtract_specialized<OperandKind::IMMEDIATE, OperandKind::VARIABLE>(process, *instr); THREADED_NEXT();
+op_sub_ii:   handle_subtract_specialized<OperandKind::IMMEDIATE, OperandKind::IMMEDIATE>(process, *instr); THREADED_NEXT();
+op_invalid:  handle_invalid(process, *instr);  THREADED_NEXT();
+
+#undef THREADED_NEXT
+#undef THREADED_DISPATCH
+#else
+    return run_switch(process, max_steps);
+#endif
+}
+
+static int run_interpreter(Process* process, int max_steps) {
+    if (process->state == ProcessState::CRASHED) return 0;
+    if (global_config.interpreter_type == InterpreterType::THREADED) {
+        return run_threaded(process, max_steps);
     }
+    return run_switch(process, max_steps);
 }
 
-void dispatch_instruction(Process* process, const Instruction& instr) {
-    if (instr.opcode == "PRINT") handle_print(process, instr);
-    else if (instr.opcode == "DECLARE") handle_declare(process, instr);
-    else if (instr.opcode == "ADD") handle_add(process, instr);
-    else if (instr.opcode == "SUBTRACT") handle_subtract(process, instr);
-    else if (instr.opcode == "SLEEP") handle_sleep(process, instr);
-    else if (instr.opcode == "FOR") handle_for(process, instr);
-    else if (instr.opcode == "READ") handle_read(process, instr);
-    else if (instr.opcode == "WRITE") handle_write(process, instr);
-    else {
-        std::cerr << "[ERROR] P" << process->id << ": Unknown instruction '" << instr.opcode << "'.\n";
-        process->state = ProcessState::CRASHED;
+int execute_instructions(Process* process, int max_steps) {
+    return run_interpreter(process, max_steps);
+}
+
+void execute_instruction(Process* process) {
+    run_interpreter(process, 1);
+}
+
+void dispatch_instruction(Process* process, const DecodedInstruction& instr) {
+    switch (instr.op) {
+    case OpCode::PRINT:    handle_print(process, instr); break;
+    case OpCode::DECLARE:  handle_declare(process, instr); break;
+    case OpCode::ADD:      handle_add(process, instr); break;
+    case OpCode::SUBTRACT: handle_subtract(process, instr); break;
+    case OpCode::SLEEP:    handle_sleep(process, instr); break;
+    case OpCode::FOR:      handle_for(process, instr); break;
+    case OpCode::READ:     handle_read(process, instr); break;
+    case OpCode::WRITE:    handle_write(process, instr); break;
+    case OpCode::ADD_VAR_VAR: handle_add_specialized<OperandKind::VARIABLE, OperandKind::VARIABLE>(process, instr); break;
+    case OpCode::ADD_VAR_IMM: handle_add_specialized<OperandKind::VARIABLE, OperandKind::IMMEDIATE>(process, instr); break;
+    case OpCode::ADD_IMM_VAR: handle_add_specialized<OperandKind::IMMEDIATE, OperandKind::VARIABLE>(process, instr); break;
+    case OpCode::ADD_IMM_IMM: handle_add_specialized<OperandKind::IMMEDIATE, OperandKind::IMMEDIATE>(process, instr); break;
+    case OpCode::SUBTRACT_VAR_VAR: handle_subtract_specialized<OperandKind::VARIABLE, OperandKind::VARIABLE>(process, instr); break;
+    case OpCode::SUBTRACT_VAR_IMM: handle_subtract_specialized<OperandKind::VARIABLE, OperandKind::IMMEDIATE>(process, instr); break;
+    case OpCode::SUBTRACT_IMM_VAR: handle_subtract_specialized<OperandKind::IMMEDIATE, OperandKind::VARIABLE>(process, instr); break;
+    case OpCode::SUBTRACT_IMM_IMM: handle_subtract_specialized<OperandKind::IMMEDIATE, OperandKind::IMMEDIATE>(process, instr); break;
+    default:               handle_invalid(process, instr); break;
     }
 }
 
-void handle_print(Process* process, const Instruction& instr) {
-    if (instr.args.empty()) return;
+void handle_print(Process* process, const DecodedInstruction& instr) {
+    if (instr.print_args.empty()) return;
 
-    std::stringstream formatted_log;
-    formatted_log << get_timestamp() << " Core:" << process->assigned_core << " \"";
+    // Stored as a compact record; the text is only built when the log is displayed.
+    ProcessLog& log = process->logs;
+    log.begin_line(current_timestamp_id(), process->assigned_core);
 
-    for (size_t i = 0; i < instr.args.size(); ++i) {
-        const std::string& arg = instr.args[i];
+    for (size_t i = 0; i < instr.print_args.size(); ++i) {
+        const Operand& arg = instr.print_args[i];
 
         // Check if the argument is a known variable in the process's symbol table.
-        if (process->variable_data_offsets.count(arg)) {
+        if (process->symbol_slots[arg.value] != UNDECLARED_SLOT) {
             // If it is a variable, read its value.
             uint16_t value_to_print = read_variable_value(process, arg);
             if (process->state == ProcessState::CRASHED) return;
-            formatted_log << value_to_print;
+            log.add_value(value_to_print);
         }
         else {
             // If it's not a variable, treat it as a literal string.
-            formatted_log << arg;
-        }
-
-        // Add a space between arguments, but not after the last one.
-        if (i < instr.args.size() - 1) {
-            formatted_log << " ";
+            log.add_text(arg.value);
         }
     }
 
-    formatted_log << "\"";
-    process->logs.push_back(formatted_log.str());
+    log.end_line(process->name, process->program.names);
 }
 
-void handle_declare(Process* process, const Instruction& instr) {
-    if (instr.args.size() != 2) { process->state = ProcessState::CRASHED; return; }
-    try {
-        long val_long = std::stol(instr.args[1]);
-        if (val_long < 0 || val_long > std::numeric_limits<uint16_t>::max()) {
-            process->state = ProcessState::CRASHED; return;
-        }
-        write_variable_value(process, instr.args[0], static_cast<uint16_t>(val_long));
-    }
-    catch (...) { process->state = ProcessState::CRASHED; }
+void handle_declare(Process* process, const DecodedInstruction& instr) {
+    write_variable_value(process, instr.dest, static_cast<uint16_t>(instr.src1.value));
 }
 
-void handle_add(Process* process, const Instruction& instr) {
-    if (instr.args.size() != 3) { process->state = ProcessState::CRASHED; return; }
-    uint16_t val1 = read_variable_value(process, instr.args[1]);
+void handle_add(Process* process, const DecodedInstruction& instr) {
+    uint16_t val1 = read_variable_value(process, instr.src1);
     if (process->state == ProcessState::CRASHED) return;
-    uint16_t val2 = read_variable_value(process, instr.args[2]);
+    uint16_t val2 = read_variable_value(process, instr.src2);
     if (process->state == ProcessState::CRASHED) return;
-    uint32_t temp_result = static_cast<uint32_t>(val1) + val2;
-    uint16_t result = std::min(temp_result, static_cast<uint32_t>(std::numeric_limits<uint16_t>::max()));
-    write_variable_value(process, instr.args[0], result);
+    write_variable_value(process, instr.dest, add_saturating(val1, val2));
 }
 
-void handle_subtract(Process* process, const Instruction& instr) {
-    if (instr.args.size() != 3) { process->state = ProcessState::CRASHED; return; }
-    uint16_t val1 = read_variable_value(process, instr.args[1]);
+void handle_subtract(Process* process, const DecodedInstruction& instr) {
+    uint16_t val1 = read_variable_value(process, instr.src1);
     if (process->state == ProcessState::CRASHED) return;
-    uint16_t val2 = read_variable_value(process, instr.args[2]);
+    uint16_t val2 = read_variable_value(process, instr.src2);
     if (process->state == ProcessState::CRASHED) return;
-    write_variable_value(process, instr.args[0], val1 - val2);
+    write_variable_value(process, instr.dest, subtract_wrapping(val1, val2));
 }
 
-void handle_sleep(Process* process, const Instruction& instr) {
-    if (instr.args.size() != 1) { process->state = ProcessState::CRASHED; return; }
-    try {
-        long sleep_val = std::stol(instr.args[0]);
-        if (sleep_val < 0 || sleep_val > 255) { process->state = ProcessState::CRASHED; return; }
-        process->state = ProcessState::WAITING;
-        process->sleep_until_tick = cpu_ticks.load() + static_cast<uint8_t>(sleep_val);
-    }
-    catch (...) { process->state = ProcessState::CRASHED; }
+void handle_sleep(Process* process, const DecodedInstruction& instr) {
+    process->state = ProcessState::WAITING;
+    process->sleep_until_tick = cpu_ticks.load() + instr.count;
 }
 
-void handle_for(Process* process, const Instruction& instr) {
-    if (instr.args.size() != 1) { process->state = ProcessState::CRASHED; return; }
-    try {
-        int repeat_count = std::stoi(instr.args[0]);
-        if (repeat_count <= 0 || instr.sub_instructions.empty()) return;
-        ForContext context;
-        context.instructions = instr.sub_instructions;
-        context.repeat_count = repeat_count;
-        process->for_stack.push(context);
+void handle_for(Process* process, const DecodedInstruction& instr) {
+    if (instr.count == 0 || instr.body.empty()) return;
+    if (process->for_stack.capacity() < MAX_FOR_NESTING) {
+        process->for_stack.reserve(MAX_FOR_NESTING);
     }
-    catch (...) { process->state = ProcessState::CRASHED; }
+    ForContext context;
+    context.body = &instr.body;
+    context.repeat_count = instr.count;
+    process->for_stack.push_back(context);
 }
 
-void handle_read(Process* process, const Instruction& instr) {
-    if (instr.args.size() != 2) {
-        std::cerr << "[ERROR] P" << process->id << ": READ requires 2 arguments.\n";
-        process->state = ProcessState::CRASHED;
-        return;
-    }
-
-    const std::string& var_name = instr.args[0];
-    const std::string& address_str = instr.args[1];
-    uint16_t address;
+void handle_read(Process* process, const DecodedInstruction& instr) {
+    uint16_t address = instr.address;
     uint16_t value_read = 0; // defaults to 0 if not initialized
 
-    if (!parse_hex_address(address_str, address)) {
-        std::cerr << "[ERROR] P" << process->id << ": Invalid hexadecimal address '" << address_str << "'.\n";
-        process->state = ProcessState::CRASHED;
-        return;
-    }
+    // Reading from the symbol table must see values still held in registers.
+    flush_registers(process, aliased_slots(address));
 
     //    The MemoryManager's readMemory will handle access violations and page faults.
-    if (!global_mem_manager->readMemory(process->id, address, value_read)) {
+    if (!load_word(process, address, value_read)) {
         process->state = ProcessState::CRASHED;
         process->faulting_address = address;
         return;
     }
 
-    write_variable_value(process, var_name, value_read);
+    write_variable_value(process, instr.dest, value_read);
 }
 
 
-void handle_write(Process* process, const Instruction& instr) {
-    if (instr.args.size() != 2) {
-        std::cerr << "[ERROR] P" << process->id << ": WRITE requires 2 arguments.\n";
-        process->state = ProcessState::CRASHED;
-        return;
-    }
+void handle_write(Process* process, const DecodedInstruction& instr) {
+    uint16_t address = instr.address;
 
-    const std::string& address_str = instr.args[0];
-    const std::string& value_str = instr.args[1];
-    uint16_t address;
-
-    if (!parse_hex_address(address_str, address)) {
-        std::cerr << "[ERROR] P" << process->id << ": Invalid hexadecimal address '" << address_str << "'.\n";
-        process->state = ProcessState::CRASHED;
-        return;
-    }
-
-    uint16_t value_to_write = read_variable_value(process, value_str);
+    uint16_t value_to_write = read_variable_value(process, instr.src1);
     if (process->state == ProcessState::CRASHED) {
         // An error occurred while reading the source value (e.g., undeclared variable)
         return;
     }
 
-    if (!global_mem_manager->writeMemory(process->id, address, value_to_write)) {
+    // Writing into the symbol table replaces variables cached in registers.
+    uint32_t aliased = aliased_slots(address);
+    flush_registers(process, aliased);
+
+    if (!store_word(process, address, value_to_write)) {
         process->state = ProcessState::CRASHED;
         process->faulting_address = address;
         return;
     }
-}
\ No newline at end of file
+    process->registers.loaded &= ~aliased;
+}
+
+void handle_invalid(Process* process, const DecodedInstruction& instr) {
+    // Malformed instructions are rejected when the program is compiled and crash here,
+    // at the point where the original instruction would have been executed.
+    if (instr.error_text != DecodedInstruction::NO_TEXT) {
+        std::cerr << "[ERROR] P" << process->id << ": " << process->program.names[instr.error_text] << "\n";
+    }
+    process->state = ProcessState::CRASHED;
+}
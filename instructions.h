@@ -7,27 +7,41 @@
 /**
  * @brief The main dispatcher for executing an instruction.
  * 
- * This function reads the instruction at the process's current program_counter
+ * This function reads the decoded instruction at the process's current program_counter
  * and calls the appropriate handler function (e.g., for PRINT, ADD, etc.).
+ * The process must have been compiled with compile_program() first.
  * 
  * @param process A pointer to the process whose instruction is to be executed.
  */
 
 
-void dispatch_instruction(Process* process, const Instruction& instr);
+void dispatch_instruction(Process* process, const DecodedInstruction& instr);
+
+// Executes one step (one CPU tick) of the process with the interpreter backend selected
+// in config.txt.
 void execute_instruction(Process* process);
-void handle_print(Process* process, const Instruction& instr);
-void handle_declare(Process* process, const Instruction& instr);
-void handle_add(Process* process, const Instruction& instr);
-void handle_subtract(Process* process, const Instruction& instr);
-void handle_sleep(Process* process, const Instruction& instr);
-void handle_for(Process* process, const Instruction& instr);
-void handle_read(Process* process, const Instruction& instr);
-void handle_write(Process* process, const Instruction& instr);
+
+// Runs steps until max_steps instructions have retired. Stops early when the program
+// ends, the process changes state (SLEEP, crash) or takes a page fault.
+// Returns the number of instructions retired.
+int execute_instructions(Process* process, int max_steps);
+
+void handle_print(Process* process, const DecodedInstruction& instr);
+void handle_declare(Process* process, const DecodedInstruction& instr);
+void handle_add(Process* process, const DecodedInstruction& instr);
+void handle_subtract(Process* process, const DecodedInstruction& instr);
+void handle_sleep(Process* process, const DecodedInstruction& instr);
+void handle_for(Process* process, const DecodedInstruction& instr);
+void handle_read(Process* process, const DecodedInstruction& instr);
+void handle_write(Process* process, const DecodedInstruction& instr);
+void handle_invalid(Process* process, const DecodedInstruction& instr);
 
 // Helper functions for memory interaction that fulfill Phase 2 requirements
-uint16_t get_variable_address(Process* process, const std::string& var_name, bool create_if_new);
-uint16_t read_variable_value(Process* process, const std::string& arg);
-void write_variable_value(Process* process, const std::string& dest_var_name, uint16_t value);
+uint16_t get_variable_address(Process* process, const Operand& var, bool create_if_new);
+uint16_t read_variable_value(Process* process, const Operand& arg);
+void write_variable_value(Process* process, const Operand& dest_var, uint16_t value);
+
+// Writes dirty register-file slots back to the process's symbol table in emulated memory.
+void flush_registers(Process* process, uint32_t slots = ~0u);
 
 #endif // INSTRUCTIONS_H
\ No newline at end of file
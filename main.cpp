@@ -8,6 +8,7 @@
 #include <ctime>
 #include <fstream>
 #include <chrono>
+#include <algorithm>
 #ifdef _WIN32
 #include <direct.h>
 #else
@@ -19,22 +20,56 @@
 #include "shared_globals.h"
 #include "config.h"
 #include "cpu_core.h"
+#include "core_pool.h"
 #include "scheduler.h"
 #include "display.h"
 #include "instructions.h"
 #include "process.h"
 #include "mem_manager.h"
 
-std::vector<std::thread> cpu_worker_threads;
+// Joined at shutdown; it waits on the tick clock, which must outlive it.
+static std::thread generator_thread;
 
 void start_cpu_cores() {
-    cpu_worker_threads.clear();
     core_busy.clear();
     core_busy.resize(global_config.num_cpu, false);
-    for (int i = 0; i < global_config.num_cpu; ++i) {
-        cpu_worker_threads.emplace_back(cpu_core_worker, i);
+    // More host threads than cores would only sit idle. Each domain gets an equal
+    // share, and at least one.
+    int host_threads = global_config.host_threads;
+    if (host_threads == 0) host_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    host_threads = std::min(host_threads, global_config.num_cpu);
+    int domains = global_config.sched_domains;
+    int threads_per_domain = std::max(1, host_threads / domains);
+    host_threads = threads_per_domain * domains;
+    run_cpu_cores(global_config.num_cpu, domains, threads_per_domain);
+    std::cout << global_config.num_cpu << " CPU cores";
+    if (domains > 1) std::cout << " in " << domains << " scheduling domains";
+    std::cout << " have been started on " << host_threads
+              << (host_threads == 1 ? " host thread." : " host threads.") << std::endl;
+}
+
+// Parses the optional deadline of screen -s/-c: a positive number of ticks from now.
+// An empty argument means no deadline.
+bool parse_deadline(const std::string& text, uint64_t& deadline_tick) {
+    deadline_tick = NO_DEADLINE;
+    if (text.empty()) return true;
+    try {
+        size_t parsed = 0;
+        long long ticks = std::stoll(text, &parsed);
+        if (parsed != text.size() || ticks < 1) return false;
+        deadline_tick = cpu_ticks.load() + static_cast<uint64_t>(ticks);
+        return true;
+    }
+    catch (...) {
+        return false;
     }
-    std::cout << global_config.num_cpu << " CPU cores have been started." << std::endl;
+}
+
+// The process is still admitted; a miss shows in screen -ls.
+void warn_deadline_overload(const std::string& process_name) {
+    std::cout << "Warning: the work due by the deadline of '" << process_name
+              << "' exceeds what " << global_config.num_cpu
+              << " cores can run in time; it is likely to be missed.\n";
 }
 
 void enter_process_screen(const std::string& process_name) {
@@ -114,9 +149,9 @@ void enter_process_screen(const std::string& process_name) {
                 Instruction for_instr;
                 for_instr.opcode = "FOR";
                 for_instr.args = { std::to_string(repeat_count) };
-                for_instr.sub_instructions = loop_body;
+                for_instr.sub_instructions = std::move(loop_body);
 
-                target_process->instructions.push_back(for_instr);
+                target_process->instructions.push_back(std::move(for_instr));
                 std::cout << "Instructions in process:\n";
                 for (size_t i = 0; i < target_process->instructions.size(); ++i) {
                     std::cout << i << ": " << target_process->instructions[i].opcode << "\n";
@@ -124,9 +159,8 @@ void enter_process_screen(const std::string& process_name) {
 
                 {
                     std::lock_guard<std::mutex> lock(queue_mutex);
-                    ready_queue.push(target_process);
+                    run_queues.enqueue(target_process);
                 }
-                queue_cv.notify_one();
             }
             else if (
                 opcode == "DECLARE" || opcode == "ADD" || opcode == "SUBTRACT" ||
@@ -151,9 +185,8 @@ void enter_process_screen(const std::string& process_name) {
 
                 {
                     std::lock_guard<std::mutex> lock(queue_mutex);
-                    ready_queue.push(target_process);
+                    run_queues.enqueue(target_process);
                 }
-                queue_cv.notify_one();
             }
             else {
                 std::cout << "Unknown command. Try one of: ADD, SUBTRACT, DECLARE, PRINT, SLEEP, FOR, process-smi, exit.\n";
@@ -176,7 +209,7 @@ void cli_loop() {
         if (!std::getline(std::cin, line)) {
             if (std::cin.eof()) {
                 system_running = false;
-                queue_cv.notify_all();
+                run_queues.wake_all();
             }
             break;
         }
@@ -189,7 +222,7 @@ void cli_loop() {
 
         if (command == "exit") {
             system_running = false;
-            queue_cv.notify_all();
+            run_queues.wake_all();
             break;
         }
         if (command == "clear") {
@@ -202,10 +235,12 @@ void cli_loop() {
             if (command == "initialize") {
                 if (loadConfiguration("config.txt", global_config)) {
                     global_mem_manager = new MemoryManager(global_config);
+                    seed_process_generators(global_config);
+                    run_queues.init(global_config.num_cpu, global_config.sched_domains);
                     is_initialized = true;
                     std::cout << "System initialized successfully from config.txt." << std::endl;
                     start_cpu_cores();
-                    std::thread(process_generator_thread).detach();
+                    generator_thread = std::thread(process_generator_thread);
                 } else {
                     std::cerr << "Initialization FAILED. Please check config.txt and try again." << std::endl;
                 }
@@ -233,23 +268,32 @@ void cli_loop() {
             if (arg1 == "-ls") {    
                 generate_system_report(std::cout);
             } else if (arg1 == "-s" && !arg2.empty() && !arg3.empty()) {
+                std::string deadline_arg;
+                ss >> deadline_arg;
+                uint64_t deadline_tick;
+                if (!parse_deadline(deadline_arg, deadline_tick)) {
+                    std::cout << "Invalid deadline '" << deadline_arg << "'. Must be a positive number of ticks.\n";
+                    continue;
+                }
                 try {
                     size_t mem_size = std::stoull(arg3);
                     // Validate memory size as per spec
                     bool is_power_of_two = (mem_size > 0) && ((mem_size & (mem_size - 1)) == 0);
                     if (is_power_of_two && mem_size >= 64 && mem_size <= 65536) {
                         std::string unique_name = generate_unique_process_name(arg2);
-                        Process* new_proc = create_random_process(unique_name, mem_size);
+                        Process* new_proc = create_random_process(unique_name, mem_size, manual_process_rng);
+                        new_proc->deadline_tick = deadline_tick;
 
                         // Register with Memory Manager.
                         if (global_mem_manager->createProcess(*new_proc)) {
+                            bool admissible = deadline_admissible(new_proc);
                             {
                                 std::lock_guard<std::mutex> lock(queue_mutex);
                                 process_list.push_back(new_proc);
-                                ready_queue.push(new_proc);
+                                run_queues.enqueue(new_proc);
                             }
-                            queue_cv.notify_all();
                             std::cout << "Process <" << unique_name << "> created.\n";
+                            if (!admissible) warn_deadline_overload(unique_name);
                         }
                         else {
                             std::cout << "Memory allocation failed for process '" << unique_name << "'.\n";
@@ -281,11 +325,27 @@ void cli_loop() {
                     // Aggressively trim whitespace and outer quotes from the entire block.
                     instruction_block.erase(0, instruction_block.find_first_not_of(" \t\n\r"));
                     instruction_block.erase(instruction_block.find_last_not_of(" \t\n\r") + 1);
+
+                    // An optional deadline follows the closing quote.
+                    std::string deadline_arg;
+                    size_t closing_quote = instruction_block.rfind('"');
+                    if (!instruction_block.empty() && instruction_block.front() == '"' &&
+                        closing_quote != std::string::npos && closing_quote > 0) {
+                        deadline_arg = instruction_block.substr(closing_quote + 1);
+                        deadline_arg.erase(0, deadline_arg.find_first_not_of(" \t"));
+                        instruction_block.erase(closing_quote + 1);
+                    }
+                    uint64_t deadline_tick;
+                    if (!parse_deadline(deadline_arg, deadline_tick)) {
+                        std::cout << "Invalid deadline '" << deadline_arg << "'. Must be a positive number of ticks.\n";
+                        continue;
+                    }
                     if (instruction_block.length() >= 2 && instruction_block.front() == '"' && instruction_block.back() == '"') {
                         instruction_block = instruction_block.substr(1, instruction_block.length() - 2);
                     }
                     std::string unique_name = generate_unique_process_name(arg2);
                     Process* new_proc = new Process(g_next_pid++, unique_name, mem_size);
+                    new_proc->deadline_tick = deadline_tick;
 
                     // Tokenize the instruction block by semicolons.
                     std::stringstream instr_stream(instruction_block);
@@ -357,20 +417,21 @@ void cli_loop() {
                         continue; 
                     }
 
+                    bool admissible = deadline_admissible(new_proc);
                     {
                         std::lock_guard<std::mutex> lock(queue_mutex);
                         process_list.push_back(new_proc);
-                        ready_queue.push(new_proc);
+                        run_queues.enqueue(new_proc);
                     }
-                    queue_cv.notify_one();
                     std::cout << "Process '" << unique_name << "' created with instructions.\n";
+                    if (!admissible) warn_deadline_overload(unique_name);
 
                 }
                 catch (const std::invalid_argument& e) {
                     std::cout << "Invalid memory size format for '" << arg3 << "'. Please provide a number.\n";
                 }
                 catch (...) {
-                    std::cout << "Invalid arguments for screen -c. Usage: screen -c <name> <size> \"<instructions>\"\n";
+                    std::cout << "Invalid arguments for screen -c. Usage: screen -c <name> <size> \"<instructions>\" [deadline]\n";
                 }
             }
             else if (arg1 == "-r" && !arg2.empty()) {
@@ -390,7 +451,7 @@ void cli_loop() {
                     if (target_process->state == ProcessState::CRASHED) {
                         std::cout << "Process <" << target_process->name
                             << "> shut down due to memory access violation error that occurred at "
-                            << target_process->end_time << ". ";
+                            << format_timestamp(target_process->end_time) << ". ";
 
                         if (target_process->faulting_address.has_value()) {
                             std::stringstream hex_stream;
@@ -410,7 +471,7 @@ void cli_loop() {
                 }
                 continue;
             } else {
-                std::cout << "Invalid screen usage. Try 'screen -ls' or 'screen -s <name> <mem_size>'.\n";
+                std::cout << "Invalid screen usage. Try 'screen -ls' or 'screen -s <name> <mem_size> [deadline]'.\n";
             }
         } else {
             std::cout << "Unknown command: '" << line << "'" << std::endl;
@@ -419,8 +480,6 @@ void cli_loop() {
 }
 
 int main() {
-    srand(static_cast<unsigned int>(time(nullptr)));
-
     std::thread master_clock_thread(clock_thread);
 
     cli_loop();
@@ -428,12 +487,9 @@ int main() {
     std::cout << "\nShutdown initiated. Waiting for background threads to complete..." << std::endl;
     
     if (master_clock_thread.joinable()) master_clock_thread.join();
+    if (generator_thread.joinable()) generator_thread.join();
 
-    for (auto& t : cpu_worker_threads) {
-        if (t.joinable()) {
-            t.join();
-        }
-    }
+    join_core_pool();
 
     // --- CLEAN UP THE MEMORY MANAGER ---
     if (global_mem_manager) {
@@ -17,15 +17,30 @@
 #include <algorithm>
 #include <map>
 #include <limits>
+#include <atomic>
 
 
 namespace fs = std::filesystem;
 
+// Translation cache per host thread. The cores sharing a host thread (see core_pool.h)
+// share its TLB; entries are tagged with the manager and pid and checked against the
+// frame, so a core that moves to another host thread only loses its cached entries, and
+// a new manager never hits entries left behind by a deleted one.
+static const size_t TLB_ENTRIES = 64;
+static thread_local TlbEntry tlb[TLB_ENTRIES];
+
+static std::atomic<uint64_t> nextInstanceId{ 1 };
+
+static size_t tlbSlot(int pid, size_t pageNum) {
+    return (static_cast<size_t>(pid) * 31 + pageNum) & (TLB_ENTRIES - 1);
+}
+
 MemoryManager::MemoryManager(const Config& config)
     : totalMemory(config.max_overall_mem),
     frameSize(config.mem_per_frame),
     backing_store_filename("csopesy-backing-store.txt"),
-    total_committed_memory(0)
+    total_committed_memory(0),
+    instanceId(nextInstanceId.fetch_add(1))
 {
     if (fs::exists(backing_store_filename)) {
         fs::remove(backing_store_filename);
@@ -33,6 +48,8 @@ MemoryManager::MemoryManager(const Config& config)
     }
 
     totalFrames = totalMemory / frameSize;
+    frameShift = 0;
+    while ((static_cast<size_t>(1) << frameShift) < frameSize) ++frameShift;
     max_pages_per_process = config.max_mem_per_proc / frameSize;
 
 
@@ -40,6 +57,8 @@ MemoryManager::MemoryManager(const Config& config)
 
     physicalMemory.resize(totalFrames, Frame(frameSize));
     frameOccupied.resize(totalFrames, false);
+    frameGeneration.resize(totalFrames, 0);
+    framePinOwner.resize(totalFrames, nullptr);
 }
 
 MemoryManager::~MemoryManager() {
@@ -127,6 +146,8 @@ void MemoryManager::removeProcess(int pid) {
 
     for (auto& page : pcb.pageTable) {
         if (page.valid && page.frameIndex != Page::INVALID_FRAME) {
+            revokePin(page.frameIndex);
+            invalidateFrame(page.frameIndex);
             frameOccupied[page.frameIndex] = false;
             frameToPageMap.erase(page.frameIndex);
         }
@@ -135,93 +156,205 @@ void MemoryManager::removeProcess(int pid) {
     /*std::cout << "[MemManager] Removed process " << pid << " and freed its frames." << std::endl;*/
 }
 
-bool MemoryManager::readMemory(int pid, uint16_t address, uint16_t& value) {
-    std::lock_guard<std::mutex> lock(manager_mutex);
+// Resolves (pid, address) to a resident page, paging it in on a fault.
+// Returns nullptr on an out-of-bounds access or when no frame could be found.
+// Must be called with manager_mutex held.
+Page* MemoryManager::translate(int pid, uint16_t address, size_t accessSize, bool& faulted) {
+    faulted = false;
+    size_t pageNum = address >> frameShift;
+
+    TlbEntry& entry = tlb[tlbSlot(pid, pageNum)];
+    if (entry.owner == instanceId && entry.pid == pid && entry.pageNum == pageNum &&
+        entry.page != nullptr && frameGeneration[entry.frameIndex] == entry.generation) {
+        tlbHits++;
+        if (address + accessSize > entry.memoryRequirement) return nullptr;
+        return entry.page;
+    }
+    tlbMisses++;
+
     auto it = processTable.find(pid);
-    if (it == processTable.end()) return false;
+    if (it == processTable.end()) return nullptr;
 
     PCB& pcb = it->second;
-    if (address + sizeof(uint16_t) > pcb.getMemoryRequirement()) return false;
-
-    size_t pageNum = address / frameSize;
-    size_t offset = address % frameSize;
-
-    if (pageNum >= pcb.pageTable.size()) return false;
+    if (address + accessSize > pcb.getMemoryRequirement()) return nullptr;
+    if (pageNum >= pcb.pageTable.size()) return nullptr;
 
     Page& page = pcb.pageTable[pageNum];
     if (!page.valid) {
+        // The page is not in a physical frame. This is a page fault.
+        faulted = true;
         pageIn(pcb, page);
-        if(!page.valid) return false;
+        if (!page.valid) return nullptr;
     }
 
+    entry.owner = instanceId;
+    entry.pid = pid;
+    entry.pageNum = pageNum;
+    entry.frameIndex = page.frameIndex;
+    entry.generation = frameGeneration[page.frameIndex];
+    entry.memoryRequirement = pcb.getMemoryRequirement();
+    entry.page = &page;
+    return &page;
+}
+
+void MemoryManager::invalidateFrame(size_t frameIndex) {
+    frameGeneration[frameIndex]++;
+}
+
+bool MemoryManager::readMemory(int pid, uint16_t address, uint16_t& value, bool* faulted,
+                               PinnedView* view) {
+    std::lock_guard<std::mutex> lock(manager_mutex);
+    bool pagedIn;
+    Page* page = translate(pid, address, sizeof(uint16_t), pagedIn);
+    if (faulted) *faulted = pagedIn;
+    if (!page) return false;
+
+    size_t offset = address & (frameSize - 1);
     if (offset + sizeof(uint16_t) > frameSize) {
         std::cerr << "[MemManager] SEGFAULT: Read for P" << pid << " at " << address
             << " crosses a page boundary.\n";
         return false;
     }
 
-    std::memcpy(&value, &physicalMemory[page.frameIndex].data[offset], sizeof(uint16_t));
-    page.lastAccessed = cpu_ticks.load();
+    std::memcpy(&value, &physicalMemory[page->frameIndex].data[offset], sizeof(uint16_t));
+    page->lastAccessed = cpu_ticks.load();
+    if (view) pinPage(pid, *page, *view);
     return true;
 }
 
-bool MemoryManager::writeMemory(int pid, uint16_t address, uint16_t value) {
+bool MemoryManager::writeMemory(int pid, uint16_t address, uint16_t value, bool* faulted,
+                                PinnedView* view) {
     std::lock_guard<std::mutex> lock(manager_mutex);
-    auto it = processTable.find(pid);
-    if (it == processTable.end()) return false;
-
-    PCB& pcb = it->second;
-    if (address + sizeof(uint16_t) > pcb.getMemoryRequirement()) return false;
-
-    size_t pageNum = address / frameSize;
-    size_t offset = address % frameSize;
-
-    if (pageNum >= pcb.pageTable.size()) return false;
-
-    Page& page = pcb.pageTable[pageNum];
-    if (!page.valid) {
-        pageIn(pcb, page);
-        if(!page.valid) return false;
-    }
+    bool pagedIn;
+    Page* page = translate(pid, address, sizeof(uint16_t), pagedIn);
+    if (faulted) *faulted = pagedIn;
+    if (!page) return false;
 
+    size_t offset = address & (frameSize - 1);
     if (offset + sizeof(uint16_t) > frameSize) {
         std::cerr << "[MemManager] SEGFAULT: Write for P" << pid << " at " << address
             << " crosses a page boundary.\n";
         return false;
     }
 
-    std::memcpy(&physicalMemory[page.frameIndex].data[offset], &value, sizeof(uint16_t));
-    page.dirty = true;
-    page.lastAccessed = cpu_ticks.load();
+    std::memcpy(&physicalMemory[page->frameIndex].data[offset], &value, sizeof(uint16_t));
+    page->dirty = true;
+    page->lastAccessed = cpu_ticks.load();
+    if (view) pinPage(pid, *page, *view);
     return true;
 }
 
-bool MemoryManager::touchPage(int pid, uint16_t address) {
+void MemoryManager::pinResidentPages(int pid, PinnedView& view) {
     std::lock_guard<std::mutex> lock(manager_mutex);
+    std::lock_guard<std::mutex> view_lock(view.mutex);
+
+    view.pid = pid;
+    view.pageData.clear();
+    view.written.clear();
+
     auto it = processTable.find(pid);
     if (it == processTable.end()) {
-        return false; // Process doesn't exist
+        view.memoryRequirement = 0;
+        return;
     }
 
     PCB& pcb = it->second;
-    if (address >= pcb.getMemoryRequirement()) {
-        return false; // Address out of bounds for this process
+    view.memoryRequirement = pcb.getMemoryRequirement();
+    view.pageData.resize(pcb.pageTable.size(), nullptr);
+    view.written.resize(pcb.pageTable.size(), 0);
+    for (Page& page : pcb.pageTable) {
+        if (page.valid && framePinOwner[page.frameIndex] == nullptr) {
+            view.pageData[page.pageNumber] = physicalMemory[page.frameIndex].data.data();
+            framePinOwner[page.frameIndex] = &view;
+        }
     }
+}
+
+// Adds a page paged in (or left unpinned) after pinResidentPages to 'view', if the view
+// is still the one for 'pid' and no other view holds the frame.
+// Must be called with manager_mutex held.
+void MemoryManager::pinPage(int pid, Page& page, PinnedView& view) {
+    std::lock_guard<std::mutex> view_lock(view.mutex);
+    if (view.pid != pid || !page.valid || framePinOwner[page.frameIndex] != nullptr) return;
+    if (page.pageNumber >= view.pageData.size()) return;
+    view.pageData[page.pageNumber] = physicalMemory[page.frameIndex].data.data();
+    framePinOwner[page.frameIndex] = &view;
+}
 
-    size_t pageNum = address / frameSize;
-    if (pageNum >= pcb.pageTable.size()) {
-        return false; // Should be caught by above check, but for safety
+void MemoryManager::unpinResidentPages(PinnedView& view) {
+    std::lock_guard<std::mutex> lock(manager_mutex);
+
+    auto it = processTable.find(view.pid);
+    if (it != processTable.end()) {
+        for (Page& page : it->second.pageTable) {
+            if (page.valid && framePinOwner[page.frameIndex] == &view) {
+                revokePin(page.frameIndex);
+            }
+        }
     }
 
-    Page& page = pcb.pageTable[pageNum];
-    if (!page.valid) {
-        // The page is not in a physical frame. This is a page fault.
-        pageIn(pcb, page);
-        return true; // Return true to signal that a fault occurred.
+    std::lock_guard<std::mutex> view_lock(view.mutex);
+    view.pid = -1;
+    view.pageData.clear();
+    view.written.clear();
+}
+
+// Takes a frame away from the view that pinned it, carrying its dirty state over to
+// the page table. Must be called with manager_mutex held.
+void MemoryManager::revokePin(size_t frameIndex) {
+    PinnedView* owner = framePinOwner[frameIndex];
+    if (owner == nullptr) return;
+
+    std::lock_guard<std::mutex> view_lock(owner->mutex);
+    auto page_id = frameToPageMap.find(frameIndex);
+    if (page_id != frameToPageMap.end()) {
+        size_t pageNum = page_id->second.second;
+        Page& page = processTable.at(page_id->second.first).pageTable[pageNum];
+        if (pageNum < owner->pageData.size()) {
+            if (owner->written[pageNum]) {
+                page.dirty = true;
+                page.lastAccessed = cpu_ticks.load();
+            }
+            owner->pageData[pageNum] = nullptr;
+            owner->written[pageNum] = 0;
+        }
     }
-    
-    // The page was already in memory, no fault occurred.
-    return false;
+    framePinOwner[frameIndex] = nullptr;
+}
+
+bool MemoryManager::readPinned(PinnedView& view, uint16_t address, uint16_t& value) {
+    std::lock_guard<std::mutex> view_lock(view.mutex);
+    if (address + sizeof(uint16_t) > view.memoryRequirement) return false;
+
+    size_t pageNum = address >> frameShift;
+    size_t offset = address & (frameSize - 1);
+    if (pageNum >= view.pageData.size() || view.pageData[pageNum] == nullptr) return false;
+    if (offset + sizeof(uint16_t) > frameSize) return false;
+
+    std::memcpy(&value, view.pageData[pageNum] + offset, sizeof(uint16_t));
+    return true;
+}
+
+bool MemoryManager::writePinned(PinnedView& view, uint16_t address, uint16_t value) {
+    std::lock_guard<std::mutex> view_lock(view.mutex);
+    if (address + sizeof(uint16_t) > view.memoryRequirement) return false;
+
+    size_t pageNum = address >> frameShift;
+    size_t offset = address & (frameSize - 1);
+    if (pageNum >= view.pageData.size() || view.pageData[pageNum] == nullptr) return false;
+    if (offset + sizeof(uint16_t) > frameSize) return false;
+
+    std::memcpy(view.pageData[pageNum] + offset, &value, sizeof(uint16_t));
+    view.written[pageNum] = 1;
+    return true;
+}
+
+bool MemoryManager::touchPage(int pid, uint16_t address) {
+    std::lock_guard<std::mutex> lock(manager_mutex);
+    bool faulted;
+    translate(pid, address, 1, faulted);
+    // Returns true to signal that a fault occurred.
+    return faulted;
 }
 
 void MemoryManager::pageIn(PCB& pcb, Page& page) {
@@ -247,7 +380,7 @@ void MemoryManager::pageIn(PCB& pcb, Page& page) {
     page.valid = true;
     page.inMemory = true;
     page.dirty = false;
-    frameQueue.push(frameIndex);
+    frameQueue.push_back(frameIndex);
     pageFaults++;
 }
 
@@ -268,6 +401,9 @@ void MemoryManager::pageOut(size_t frameIndex) {
 
     Page& page = pcb.pageTable[pageNum];
 
+    // A core may still have this frame pinned; take it back (and its dirty bit) first.
+    revokePin(frameIndex);
+
     //If the page is dirty, write its contents to the backing store. >>>
     if (page.dirty) {
         /*   FOR DEBUGGING PURPOSES
@@ -281,6 +417,7 @@ void MemoryManager::pageOut(size_t frameIndex) {
     page.valid = false;
     page.inMemory = false;
     page.frameIndex = Page::INVALID_FRAME;
+    invalidateFrame(frameIndex);
     frameOccupied[frameIndex] = false;
     frameToPageMap.erase(frameIndex);
 }
@@ -296,14 +433,26 @@ size_t MemoryManager::getFreeFrameOrEvict() {
         return -1;
     }
     
-    size_t victimFrame = Page::INVALID_FRAME;
-    while (!frameQueue.empty()) {
-        size_t potentialVictim = frameQueue.front();
-        frameQueue.pop();
-        if (frameOccupied[potentialVictim]) {
-            victimFrame = potentialVictim;
+    // The victim is the oldest frame not pinned by a running core. Pinned frames keep
+    // their place in the FIFO order; if every frame is pinned, the oldest goes anyway.
+    auto victim = frameQueue.end();
+    for (auto it = frameQueue.begin(); it != frameQueue.end();) {
+        if (!frameOccupied[*it]) {
+            it = frameQueue.erase(it); // Freed since it was queued
+            continue;
+        }
+        if (framePinOwner[*it] == nullptr) {
+            victim = it;
             break;
         }
+        ++it;
+    }
+    if (victim == frameQueue.end()) victim = frameQueue.begin();
+
+    size_t victimFrame = Page::INVALID_FRAME;
+    if (victim != frameQueue.end()) {
+        victimFrame = *victim;
+        frameQueue.erase(victim);
     }
     
     if (victimFrame != Page::INVALID_FRAME) {
@@ -2,7 +2,7 @@
 #include "frame.h"
 #include <vector>
 #include <unordered_map>
-#include <queue>
+#include <deque>
 #include <string>
 #include <cstdint>
 #include <mutex>
@@ -13,6 +13,31 @@
 // Forward-declare Process to avoid circular dependency
 struct Process;
 
+// A cached (pid, virtual page) -> resident page translation. It is only trusted while
+// the frame's generation still matches; pageOut and removeProcess bump the generation.
+// 'owner' is the instanceId of the MemoryManager that filled it, since the TLB
+// outlives any one manager.
+struct TlbEntry {
+    uint64_t owner = 0;
+    int pid = -1;
+    size_t pageNum = 0;
+    size_t frameIndex = 0;
+    uint64_t generation = 0;
+    size_t memoryRequirement = 0;
+    Page* page = nullptr;
+};
+
+// A process's resident pages, pinned for the duration of a CPU slice. The owning core
+// reads and writes pinned frames under the view's own (uncontended) mutex instead of
+// manager_mutex. If the pager has to evict a pinned frame it revokes that page first.
+struct PinnedView {
+    std::mutex mutex;
+    int pid = -1;
+    size_t memoryRequirement = 0;
+    std::vector<uint8_t*> pageData; // Frame data per virtual page, nullptr if not pinned
+    std::vector<uint8_t> written;   // Per virtual page: written since it was pinned
+};
+
 class MemoryManager {
 public:
     MemoryManager(const Config& config);
@@ -23,10 +48,25 @@ public:
     void removeProcess(int pid);
     bool isProcessActive(int pid);
 
-    // Memory access interface (used by instructions)
-    bool readMemory(int pid, uint16_t address, uint16_t& value);
-    bool writeMemory(int pid, uint16_t address, uint16_t value);
+    // Memory access interface (used by instructions). 'faulted', if given, is set when
+    // the access had to page the data in. 'view', if given, is the caller's pinned view
+    // of 'pid': the accessed page is pinned into it, so the rest of the slice reaches
+    // the page without manager_mutex. (A TLB hit here is still taken under the lock,
+    // since an unlocked access could race the pager evicting the frame.)
+    bool readMemory(int pid, uint16_t address, uint16_t& value, bool* faulted = nullptr,
+                    PinnedView* view = nullptr);
+    bool writeMemory(int pid, uint16_t address, uint16_t value, bool* faulted = nullptr,
+                     PinnedView* view = nullptr);
     
+    // Slice-level access: pin the process's resident pages once, access them without
+    // manager_mutex, and fold the accessed/dirty state back into the page table on unpin.
+    // readPinned/writePinned return false when the page is not pinned; callers then fall
+    // back to readMemory/writeMemory.
+    void pinResidentPages(int pid, PinnedView& view);
+    void unpinResidentPages(PinnedView& view);
+    bool readPinned(PinnedView& view, uint16_t address, uint16_t& value);
+    bool writePinned(PinnedView& view, uint16_t address, uint16_t value);
+
     // Checks if a page is valid. If not, pages it in.
     // Returns true if a page fault occurred, false otherwise.
     bool touchPage(int pid, uint16_t address);
@@ -49,11 +89,14 @@ public:
 
     size_t getPageInCount() const { return pageFaults; }
     size_t getPageOutCount() const { return pageEvictions; }
+    size_t getTlbHitCount() const { return tlbHits; }
+    size_t getTlbMissCount() const { return tlbMisses; }
 
 private:
     // Core memory components
     size_t totalMemory;
     size_t frameSize;
+    size_t frameShift; // log2(frameSize); mem-per-frame is validated to be a power of 2
     size_t totalFrames;
     size_t max_pages_per_process;
     size_t total_committed_memory = 0;
@@ -65,7 +108,7 @@ private:
     void readPageFromBackingStore(int pid, size_t pageNum, std::vector<uint8_t>& data);
 
     // Page replacement (FIFO)
-    std::queue<size_t> frameQueue;
+    std::deque<size_t> frameQueue;
 
     // Process and Page management
     std::unordered_map<int, PCB> processTable;
@@ -74,6 +117,18 @@ private:
     // Statistics
     size_t pageFaults = 0;
     size_t pageEvictions = 0;
+    size_t tlbHits = 0;
+    size_t tlbMisses = 0;
+
+    // Address translation. Each core thread keeps its own TLB (see mem_manager.cpp);
+    // frameGeneration lets those entries be invalidated without touching other threads.
+    std::vector<uint64_t> frameGeneration;
+    uint64_t instanceId; // Unique per manager, never 0; tags this manager's TLB entries
+    std::vector<PinnedView*> framePinOwner;
+    void pinPage(int pid, Page& page, PinnedView& view);
+    void revokePin(size_t frameIndex);
+    Page* translate(int pid, uint16_t address, size_t accessSize, bool& faulted);
+    void invalidateFrame(size_t frameIndex);
 
     // Paging mechanism
     size_t getFreeFrameOrEvict();
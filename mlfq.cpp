@@ -0,0 +1,51 @@
+#include "mlfq.h"
+#include "shared_globals.h"
+#include <atomic>
+
+static const int SEQ_BITS = 48;
+
+static std::atomic<uint64_t> boost_count{ 0 };
+// Stamps Process::ready_seq; shared by every core's queue so stealing keeps FIFO order.
+static std::atomic<uint64_t> next_ready_seq{ 1 };
+
+int mlfq_quantum(int level) {
+    return global_config.mlfq_quanta[level];
+}
+
+int64_t mlfq_key(int level, uint64_t seq) {
+    return (static_cast<int64_t>(level) << SEQ_BITS) |
+        static_cast<int64_t>(seq & ((uint64_t(1) << SEQ_BITS) - 1));
+}
+
+// Puts 'process' back at level 0 if a boost happened since it last looked. Called by
+// whoever owns the process: its core, or the holder of its run-queue lock.
+static void mlfq_catch_up_boost(Process* process) {
+    uint64_t boosts = boost_count.load(std::memory_order_relaxed);
+    if (process->mlfq_boosts_seen != boosts) {
+        process->mlfq_boosts_seen = boosts;
+        process->mlfq_level = 0;
+    }
+}
+
+void mlfq_enqueue(Process* process) {
+    mlfq_catch_up_boost(process);
+    if (process->ready_index == NOT_QUEUED) process->ready_seq = next_ready_seq++;
+}
+
+void mlfq_end_slice(Process* process, int executed) {
+    mlfq_catch_up_boost(process);
+    bool gave_up_early = process->state == ProcessState::WAITING ||
+        process->had_page_fault || process->paged_in;
+    if (gave_up_early) {
+        if (process->mlfq_level > 0) process->mlfq_level--;
+    }
+    else if (executed >= mlfq_quantum(process->mlfq_level) &&
+             process->mlfq_level < global_config.mlfq_levels - 1) {
+        process->mlfq_level++;
+    }
+}
+
+void mlfq_boost() {
+    boost_count++;
+    run_queues.rekey();
+}
@@ -0,0 +1,35 @@
+#ifndef MLFQ_H
+#define MLFQ_H
+
+#include <cstdint>
+#include "process.h"
+
+// Multi-level feedback queue ("mlfq" policy). A process starts at level 0, drops a
+// level each time it uses up its level's quantum, and climbs one each time it gives
+// the core up early (SLEEP or a page fault), so short and I/O-bound processes stay
+// near the top. Every mlfq-boost-ticks all processes go back to level 0, so CPU-bound
+// ones cannot starve. Within a level processes take turns in queue order.
+//
+// A boost does not touch running or sleeping processes. Each process remembers the
+// last boost it saw and catches up the next time it is queued or leaves a core.
+
+// Quantum, in instructions, of a process at 'level'.
+int mlfq_quantum(int level);
+
+// Ready-queue key: lower levels first, then queue order. With seq 0 it is the lowest
+// key at 'level', the one a waiting process must beat to preempt.
+int64_t mlfq_key(int level, uint64_t seq);
+
+// Prepares 'process' for its ready queue: applies any boost it missed and, unless it
+// is only being re-keyed in place, stamps its place in line. Called under the lock of
+// the run queue it goes to.
+void mlfq_enqueue(Process* process);
+
+// Moves 'process' a level after a slice of 'executed' instructions: down if it used
+// its whole quantum, up if it slept or faulted first.
+void mlfq_end_slice(Process* process, int executed);
+
+// Starts a new boost period and re-keys every queued process. Called by clock_thread.
+void mlfq_boost();
+
+#endif // MLFQ_H
@@ -3,10 +3,12 @@
 
 #include <string>
 #include <vector>
-#include <map>
 #include <cstdint>
-#include <stack>
 #include <optional>
+#include <atomic>
+#include "bytecode.h"
+#include "process_log.h"
+#include "timestamp.h"
 
 struct Instruction {
     std::string opcode;
@@ -22,10 +24,35 @@ enum class ProcessState {
     CRASHED
 };
 
+struct PinnedView; // Defined in mem_manager.h
+
+const uint16_t SYMBOL_TABLE_SIZE = 64;
+const int SYMBOL_TABLE_SLOTS = SYMBOL_TABLE_SIZE / sizeof(uint16_t);
+const int8_t UNDECLARED_SLOT = -1;
+
+const int NOT_QUEUED = -1; // Process::ready_index of a process outside the ready queue
+const uint64_t NO_DEADLINE = 0; // Process::deadline_tick of a process without a deadline
+
+// Caches the symbol-table variables so ADD/SUBTRACT/PRINT do not go through the
+// MemoryManager for every operand. Emulated memory is updated from the dirty
+// slots when the process leaves its core, or when a READ/WRITE touches the
+// symbol-table addresses.
+struct RegisterFile {
+    uint16_t values[SYMBOL_TABLE_SLOTS] = {};
+    uint32_t loaded = 0; // Bit per slot: value holds the variable's current contents
+    uint32_t dirty = 0;  // Bit per slot: value has not been written back yet
+};
+
+// Nesting depth of FOR loops allowed by the spec. Deeper loops still run, but
+// for_stack only reserves room for this many frames up front.
+const size_t MAX_FOR_NESTING = 3;
+
+// One active FOR loop. The frame refers to the loop body inside Process::program
+// instead of copying it; compile_program re-binds 'body' if the program grows.
 struct ForContext {
-    std::vector<Instruction> instructions;
-    int repeat_count = 0;
-    int current_repeat = 0;
+    const std::vector<DecodedInstruction>* body = nullptr;
+    uint32_t repeat_count = 0;
+    uint32_t current_repeat = 0;
     size_t current_instruction_index = 0;
 };
 
@@ -35,30 +62,52 @@ struct Process {
 
     size_t memory_required = 0;
     
-    // Maps variable names to their OFFSET from the start of the data segment.
-    std::map<std::string, uint16_t> variable_data_offsets; 
+    // Maps a variable's name id (Program::names) to its 2-byte slot in the symbol table,
+    // or UNDECLARED_SLOT. Sized by compile_program, filled in as variables are declared.
+    std::vector<int8_t> symbol_slots;
     uint16_t next_available_variable_offset = 0;
+    RegisterFile registers;
     
     std::optional<uint16_t> faulting_address;
 
+    // Source form of the program, kept for display. Execution runs 'program'.
     std::vector<Instruction> instructions;
+    Program program;
     int program_counter = 0;
     
     int assigned_core = -1;
     bool finished = false;
-    std::string start_time;
-    std::string end_time;
-    std::vector<std::string> logs;
+    TimestampId start_time = NO_TIMESTAMP; // First dispatch
+    TimestampId end_time = NO_TIMESTAMP;   // Finished or crashed
+    uint64_t end_tick = 0;
+    uint64_t deadline_tick = NO_DEADLINE;  // Tick it should finish by, see the "edf" policy
+    ProcessLog logs; // PRINT output
 
     int priority = 0;
     int last_core = -1;
+    int ready_index = NOT_QUEUED; // Heap position in its ReadyQueue (0 in FIFO mode)
+    // Core whose run queue holds the process, see RunQueues. Written under that queue's
+    // lock, but RunQueues::enqueue reads it before it knows which lock to take.
+    std::atomic<int> queued_core{ -1 };
+    uint64_t ready_seq = 0;       // Order of queueing, for FIFO order within an MLFQ level
+
+    int mlfq_level = 0;            // See mlfq.h
+    uint64_t mlfq_boosts_seen = 0;
+    uint64_t vruntime = 0;         // See cfs.h
+    bool cfs_requeued = false;     // Back from a slice, not placed again (see cfs_place)
 
     ProcessState state = ProcessState::READY;
     uint64_t sleep_until_tick = 0;
 
-    std::stack<ForContext> for_stack;
+    std::vector<ForContext> for_stack; // Innermost loop at the back
 
     bool had_page_fault = false; // in Process class
+    // A page fault was serviced (the page paged in) during the current slice. The
+    // instruction still completed; policies that treat a fault as blocking I/O yield.
+    bool paged_in = false;
+
+    // The core's view of this process's resident pages while it is running, or nullptr.
+    PinnedView* pinned_pages = nullptr;
 
     Process() : id(0), name("") {}
    
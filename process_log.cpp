@@ -0,0 +1,177 @@
+#include "process_log.h"
+#include "shared_globals.h"
+#include <fstream>
+#include <sstream>
+
+const char* const LOG_SPILL_FILENAME = "csopesy-process-logs.txt";
+
+namespace {
+
+// Shared by every process; the file is truncated on the first spill of a run.
+std::mutex spill_mutex;
+std::ofstream spill_file;
+
+void spill(const std::string& process_name, const std::string& line) {
+    std::lock_guard<std::mutex> lock(spill_mutex);
+    if (!spill_file.is_open()) {
+        spill_file.open(LOG_SPILL_FILENAME, std::ios::out | std::ios::trunc);
+    }
+    spill_file << process_name << " " << line << "\n";
+}
+
+// Writes the cells of one record of a line, space-separated from the cells before it.
+void format_cells(std::ostream& out, const LogRecord& record, bool& first_cell,
+                  const std::vector<std::string>& names) {
+    for (uint8_t c = 0; c < record.cell_count; ++c) {
+        if (!first_cell) out << " ";
+        first_cell = false;
+        uint32_t cell = record.cells[c];
+        if (cell & LogRecord::VALUE_BIT) out << (cell & 0xFFFFu);
+        else out << names[cell];
+    }
+}
+
+} // namespace
+
+ProcessLog::ProcessLog(const ProcessLog& other) {
+    std::lock_guard<std::mutex> lock(other.mutex_);
+    records_ = other.records_;
+    head_ = other.head_;
+    count_ = other.count_;
+    evicted_ = other.evicted_;
+    spilled_ = other.spilled_;
+}
+
+ProcessLog& ProcessLog::operator=(const ProcessLog& other) {
+    if (this == &other) return *this;
+    std::scoped_lock lock(mutex_, other.mutex_);
+    records_ = other.records_;
+    head_ = other.head_;
+    count_ = other.count_;
+    evicted_ = other.evicted_;
+    spilled_ = other.spilled_;
+    pending_.clear();
+    return *this;
+}
+
+void ProcessLog::begin_line(TimestampId timestamp, int core) {
+    pending_.clear();
+    LogRecord record;
+    record.timestamp = timestamp;
+    record.core = static_cast<int16_t>(core);
+    pending_.push_back(record);
+}
+
+void ProcessLog::add_value(uint16_t value) {
+    add_text(LogRecord::VALUE_BIT | value);
+}
+
+void ProcessLog::add_text(uint32_t name_id) {
+    if (pending_.back().cell_count == LOG_RECORD_CELLS) {
+        LogRecord record;
+        record.timestamp = pending_.back().timestamp;
+        record.core = pending_.back().core;
+        record.continuation = true;
+        pending_.push_back(record);
+    }
+    LogRecord& record = pending_.back();
+    record.cells[record.cell_count++] = name_id;
+}
+
+void ProcessLog::end_line(const std::string& process_name, const std::vector<std::string>& names) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // A line spanning more records than the ring holds cannot be kept. The retained
+    // lines go first, so a spill file stays in order, then the line is spilled or dropped.
+    if (pending_.size() > static_cast<size_t>(global_config.log_capacity)) {
+        while (count_ > 0) evict_line(process_name, names);
+        if (global_config.log_spill) {
+            const LogRecord& head = pending_.front();
+            std::ostringstream line;
+            line << format_timestamp(head.timestamp) << " Core:" << head.core << " \"";
+            bool first_cell = true;
+            for (const LogRecord& record : pending_) format_cells(line, record, first_cell, names);
+            line << "\"";
+            spill(process_name, line.str());
+            spilled_ = true;
+        }
+        evicted_++;
+        pending_.clear();
+        return;
+    }
+    for (const LogRecord& record : pending_) {
+        push_record(record, process_name, names);
+    }
+    pending_.clear();
+}
+
+void ProcessLog::push_record(const LogRecord& record, const std::string& process_name,
+                             const std::vector<std::string>& names) {
+    size_t capacity = static_cast<size_t>(global_config.log_capacity);
+    if (records_.size() < capacity && head_ == 0) {
+        records_.push_back(record);
+        count_++;
+        return;
+    }
+    if (count_ == records_.size()) {
+        evict_line(process_name, names);
+    }
+    records_[index(count_)] = record;
+    count_++;
+}
+
+// Removes the oldest line, including its continuation records.
+void ProcessLog::evict_line(const std::string& process_name, const std::vector<std::string>& names) {
+    if (count_ == 0) return;
+    if (global_config.log_spill) {
+        std::ostringstream line;
+        format_line(line, 0, names);
+        spill(process_name, line.str());
+        spilled_ = true;
+    }
+    do {
+        head_ = (head_ + 1) % records_.size();
+        count_--;
+    } while (count_ > 0 && records_[head_].continuation);
+    evicted_++;
+}
+
+bool ProcessLog::empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_ == 0;
+}
+
+uint64_t ProcessLog::evicted_lines() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evicted_;
+}
+
+bool ProcessLog::spilled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return spilled_;
+}
+
+// Formats the line starting at record 'first' (relative to the oldest) and returns
+// the number of records it spans.
+size_t ProcessLog::format_line(std::ostream& out, size_t first, const std::vector<std::string>& names) const {
+    const LogRecord& head = records_[index(first)];
+    out << format_timestamp(head.timestamp) << " Core:" << head.core << " \"";
+
+    size_t used = 0;
+    bool first_cell = true;
+    do {
+        format_cells(out, records_[index(first + used)], first_cell, names);
+        used++;
+    } while (first + used < count_ && records_[index(first + used)].continuation);
+
+    out << "\"";
+    return used;
+}
+
+void ProcessLog::print(std::ostream& out, const std::vector<std::string>& names) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t i = 0;
+    while (i < count_) {
+        i += format_line(out, i, names);
+        out << "\n";
+    }
+}
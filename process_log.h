@@ -0,0 +1,75 @@
+#ifndef PROCESS_LOG_H
+#define PROCESS_LOG_H
+
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "timestamp.h"
+
+// Cells per LogRecord. A PRINT with more arguments continues in the next record(s).
+const int LOG_RECORD_CELLS = 5;
+
+// File that receives the oldest PRINT lines when 'log-spill' is enabled.
+extern const char* const LOG_SPILL_FILENAME;
+
+// One PRINT line (or a continuation of one) in compact form. Each cell is either a
+// printed value or the id of a literal in Program::names.
+struct LogRecord {
+    static const uint32_t VALUE_BIT = 0x80000000u;
+
+    TimestampId timestamp = NO_TIMESTAMP;
+    int16_t core = -1;
+    uint8_t cell_count = 0;
+    bool continuation = false; // Carries more cells of the previous record's line
+    uint32_t cells[LOG_RECORD_CELLS] = {};
+};
+
+// Bounded per-process PRINT output. Lines are kept as LogRecords in a ring of
+// 'log-capacity' records and only formatted when displayed. When the ring is
+// full the oldest line is dropped, or appended to LOG_SPILL_FILENAME if
+// 'log-spill' is enabled. A line longer than the whole ring is never stored: it
+// evicts every retained line and is then dropped or spilled itself.
+class ProcessLog {
+public:
+    ProcessLog() = default;
+    ProcessLog(const ProcessLog& other);
+    ProcessLog& operator=(const ProcessLog& other);
+
+    // Starts a new line. Follow with add_value/add_text, then end_line.
+    void begin_line(TimestampId timestamp, int core);
+    void add_value(uint16_t value);
+    void add_text(uint32_t name_id);
+    // Stores the line built since begin_line. 'names' resolves text cells for spilling.
+    void end_line(const std::string& process_name, const std::vector<std::string>& names);
+
+    bool empty() const;
+    // Writes the retained lines, oldest first, one per output line.
+    void print(std::ostream& out, const std::vector<std::string>& names) const;
+    // Lines no longer held in memory (dropped, or written to LOG_SPILL_FILENAME).
+    uint64_t evicted_lines() const;
+    bool spilled() const;
+
+    // Held while Program::names may be appended to, since print() reads it.
+    std::mutex& mutex() const { return mutex_; }
+
+private:
+    size_t index(size_t i) const { return (head_ + i) % records_.size(); }
+    void push_record(const LogRecord& record, const std::string& process_name,
+                     const std::vector<std::string>& names);
+    void evict_line(const std::string& process_name, const std::vector<std::string>& names);
+    size_t format_line(std::ostream& out, size_t first, const std::vector<std::string>& names) const;
+
+    mutable std::mutex mutex_;
+    std::vector<LogRecord> records_; // Grows up to the capacity, then used as a ring
+    size_t head_ = 0;                // Oldest record
+    size_t count_ = 0;
+    uint64_t evicted_ = 0;
+    bool spilled_ = false;
+
+    // The line under construction (written by the owning core only).
+    std::vector<LogRecord> pending_;
+};
+
+#endif // PROCESS_LOG_H
@@ -0,0 +1,151 @@
+#include "ready_queue.h"
+#include "shared_globals.h"
+#include "scheduler_policy.h"
+
+bool ReadyQueue::is_ordered(SchedulerType policy) {
+    return dispatch_policy(policy, [](auto p) { return decltype(p)::ordered; });
+}
+
+bool ReadyQueue::before(const HeapEntry& a, const HeapEntry& b) {
+    return (a.key == b.key) ? a.process->id < b.process->id : a.key < b.key;
+}
+
+void ReadyQueue::push(Process* process) {
+    dispatch_policy(global_config.scheduler_type, [this, process](auto policy) {
+        push_as<decltype(policy)>(process);
+    });
+}
+
+template <typename Policy>
+void ReadyQueue::push_as(Process* process) {
+    if constexpr (!Policy::ordered) {
+        if (process->ready_index != NOT_QUEUED) return;
+        if (fifo_count_ == fifo_.size()) {
+            // Full: unroll the ring into a buffer twice the size.
+            std::vector<Process*> grown(fifo_.empty() ? 16 : fifo_.size() * 2);
+            for (size_t i = 0; i < fifo_count_; ++i) {
+                grown[i] = fifo_[(fifo_head_ + i) % fifo_.size()];
+            }
+            fifo_.swap(grown);
+            fifo_head_ = 0;
+        }
+        fifo_[(fifo_head_ + fifo_count_) % fifo_.size()] = process;
+        fifo_count_++;
+        process->ready_index = 0;
+        return;
+    }
+
+    Policy::on_enqueue(process);
+    HeapEntry entry{ Policy::key(process), process };
+    if (process->ready_index != NOT_QUEUED) {
+        // Already queued: re-key it where it is.
+        size_t index = static_cast<size_t>(process->ready_index);
+        bool raised = before(entry, heap_[index]);
+        heap_[index].key = entry.key;
+        if (raised) sift_up(index);
+        else sift_down(index);
+        publish_best_key();
+        return;
+    }
+    heap_.push_back(entry);
+    process->ready_index = static_cast<int>(heap_.size() - 1);
+    sift_up(heap_.size() - 1);
+    publish_best_key();
+}
+
+Process* ReadyQueue::pop() {
+    if (!heap_.empty()) {
+        Process* selected = heap_.front().process;
+        HeapEntry last = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty()) {
+            place(0, last);
+            sift_down(0);
+        }
+        selected->ready_index = NOT_QUEUED;
+        publish_best_key();
+        return selected;
+    }
+    if (fifo_count_ > 0) {
+        Process* selected = fifo_[fifo_head_];
+        fifo_head_ = (fifo_head_ + 1) % fifo_.size();
+        fifo_count_--;
+        selected->ready_index = NOT_QUEUED;
+        return selected;
+    }
+    return nullptr;
+}
+
+Process* ReadyQueue::pop_back() {
+    if (!heap_.empty()) {
+        // The last element is a leaf, so removing it keeps the heap valid.
+        Process* selected = heap_.back().process;
+        heap_.pop_back();
+        selected->ready_index = NOT_QUEUED;
+        publish_best_key();
+        return selected;
+    }
+    if (fifo_count_ > 0) {
+        fifo_count_--;
+        Process* selected = fifo_[(fifo_head_ + fifo_count_) % fifo_.size()];
+        selected->ready_index = NOT_QUEUED;
+        return selected;
+    }
+    return nullptr;
+}
+
+Process* ReadyQueue::top() const {
+    if (!heap_.empty()) return heap_.front().process;
+    if (fifo_count_ > 0) return fifo_[fifo_head_];
+    return nullptr;
+}
+
+void ReadyQueue::rekey() {
+    dispatch_policy(global_config.scheduler_type, [this](auto policy) {
+        rekey_as<decltype(policy)>();
+    });
+}
+
+template <typename Policy>
+void ReadyQueue::rekey_as() {
+    for (HeapEntry& entry : heap_) {
+        Policy::on_enqueue(entry.process);
+        entry.key = Policy::key(entry.process);
+    }
+    for (size_t index = heap_.size() / 2; index-- > 0;) sift_down(index);
+    publish_best_key();
+}
+
+void ReadyQueue::publish_best_key() {
+    best_key_.store(heap_.empty() ? NO_WAITING_KEY : heap_.front().key, std::memory_order_relaxed);
+}
+
+void ReadyQueue::place(size_t index, const HeapEntry& entry) {
+    heap_[index] = entry;
+    entry.process->ready_index = static_cast<int>(index);
+}
+
+void ReadyQueue::sift_up(size_t index) {
+    HeapEntry entry = heap_[index];
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!before(entry, heap_[parent])) break;
+        place(index, heap_[parent]);
+        index = parent;
+    }
+    place(index, entry);
+}
+
+void ReadyQueue::sift_down(size_t index) {
+    HeapEntry entry = heap_[index];
+    size_t count = heap_.size();
+    for (;;) {
+        size_t child = 2 * index + 1;
+        if (child >= count) break;
+        if (child + 1 < count && before(heap_[child + 1], heap_[child])) child++;
+        if (!before(heap_[child], entry)) break;
+        place(index, heap_[child]);
+        index = child;
+    }
+    place(index, entry);
+}
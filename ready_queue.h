@@ -0,0 +1,75 @@
+#ifndef READY_QUEUE_H
+#define READY_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "config.h"
+#include "process.h"
+
+// Processes waiting for a core, ordered by the active scheduling policy:
+//   - FCFS/RR: a FIFO ring buffer.
+//   - SJF, SRTF, priority, MLFQ, CFS, EDF: an indexed binary min-heap on (key, pid),
+//     where the key is the instruction count, the remaining instruction count, the
+//     priority, the MLFQ level and queueing order, the CFS vruntime, or the deadline.
+// The key comes from the policy's key() hook when a process is pushed; pushing a
+// process that is already queued updates its key in place instead of queueing it twice.
+// Push and pop are O(1)/O(log n) and only allocate when the queue outgrows its previous
+// maximum size.
+//
+// Not synchronized; callers hold the per-core run-queue lock that guards the queue (see
+// RunQueues). The one exception is best_waiting_key(), which RunQueues reads without
+// that lock to publish the best key of each domain.
+class ReadyQueue {
+public:
+    static constexpr int64_t NO_WAITING_KEY = std::numeric_limits<int64_t>::max();
+
+    void push(Process* process);
+    // Removes and returns the next process to run, or nullptr if the queue is empty.
+    Process* pop();
+    // Removes and returns the process that would run last (the FIFO tail, or a heap
+    // leaf), or nullptr. Used to move work between cores without jumping the queue.
+    Process* pop_back();
+    // The process pop() would return, without removing it.
+    Process* top() const;
+    // Recomputes every key, after something outside the queue changed them (an MLFQ
+    // boost), and restores the heap order.
+    void rekey();
+
+    bool empty() const { return size() == 0; }
+    size_t size() const { return heap_.size() + fifo_count_; }
+
+    // True for the policies that use the heap (SJF, SRTF, priority, MLFQ, CFS, EDF).
+    static bool is_ordered(SchedulerType policy);
+
+    // Key of the best process in the heap, or NO_WAITING_KEY if it is empty (always the
+    // case in FIFO mode). Republished on every change, so a preemption check is a
+    // single relaxed load.
+    int64_t best_waiting_key() const { return best_key_.load(std::memory_order_relaxed); }
+
+private:
+    struct HeapEntry {
+        int64_t key;
+        Process* process;
+    };
+
+    // push() and rekey() for the configured policy (see scheduler_policy.h).
+    template <typename Policy> void push_as(Process* process);
+    template <typename Policy> void rekey_as();
+
+    static bool before(const HeapEntry& a, const HeapEntry& b);
+    void place(size_t index, const HeapEntry& entry);
+    void sift_up(size_t index);
+    void sift_down(size_t index);
+    void publish_best_key();
+
+    std::vector<HeapEntry> heap_;
+    std::atomic<int64_t> best_key_{ NO_WAITING_KEY };
+
+    std::vector<Process*> fifo_; // Ring buffer
+    size_t fifo_head_ = 0;
+    size_t fifo_count_ = 0;
+};
+
+#endif // READY_QUEUE_H
@@ -0,0 +1,383 @@
+#include "run_queues.h"
+#include "shared_globals.h"
+#include "core_pool.h"
+#include "sched_domains.h"
+#include <algorithm>
+
+void RunQueues::init(int core_count, int domain_count) {
+    cores_.reset(new CoreRunQueue[core_count]);
+    core_count_ = core_count;
+    domains_.reset(new Domain[domain_count]);
+    domain_count_ = domain_count;
+    for (int domain = 0; domain < domain_count; ++domain) {
+        Domain& d = domains_[domain];
+        d.first_core = domain_first(domain, core_count, domain_count);
+        d.end_core = domain_first(domain + 1, core_count, domain_count);
+        for (int core = d.first_core; core < d.end_core; ++core) cores_[core].domain = domain;
+        d.leaves = 1;
+        while (d.leaves < d.end_core - d.first_core) d.leaves *= 2;
+        d.keys.reset(new KeyNode[2 * d.leaves]);
+    }
+    idle_mask_words_ = (core_count + 63) / 64;
+    idle_mask_.reset(new std::atomic<uint64_t>[idle_mask_words_]);
+    for (int word = 0; word < idle_mask_words_; ++word) idle_mask_[word] = 0;
+}
+
+int RunQueues::load_of(int core) const {
+    return cores_[core].length.load(std::memory_order_relaxed) +
+        (cores_[core].busy.load(std::memory_order_relaxed) ? 1 : 0);
+}
+
+int RunQueues::domain_load(int domain) const {
+    return domains_[domain].queued.load(std::memory_order_relaxed) +
+        domains_[domain].busy.load(std::memory_order_relaxed);
+}
+
+// The scans start at an offset (a pid) so ties do not all land on the first core.
+int RunQueues::least_loaded_core(int domain, int offset) const {
+    const Domain& d = domains_[domain];
+    int size = d.end_core - d.first_core;
+    int least = d.first_core + offset % size;
+    for (int i = 1; i < size; ++i) {
+        int core = d.first_core + (offset + i) % size;
+        if (load_of(core) < load_of(least)) least = core;
+    }
+    return least;
+}
+
+int RunQueues::least_loaded_domain(int offset) const {
+    int least = offset % domain_count_;
+    for (int i = 1; i < domain_count_; ++i) {
+        int domain = (offset + i) % domain_count_;
+        if (domain_load(domain) < domain_load(least)) least = domain;
+    }
+    return least;
+}
+
+// The process's last core keeps it (warm caches, pinned-page locality) unless that
+// core is more than RUN_QUEUE_IMBALANCE_THRESHOLD busier than the least-loaded core of
+// its domain, or is busy while a core of the domain is idle. Then the domain keeps it,
+// unless the domain is more than domain-imbalance busier than the least-loaded domain.
+// 'caller_core' is about to dispatch, so it does not count as busy.
+int RunQueues::choose_core(const Process* process, int caller_core) const {
+    int preferred = process->last_core;
+    if (preferred < 0 || preferred >= core_count_) {
+        return least_loaded_core(least_loaded_domain(process->id), process->id);
+    }
+
+    int domain = cores_[preferred].domain;
+    int least = least_loaded_core(domain, process->id);
+    int preferred_load = load_of(preferred);
+    int least_load = load_of(least);
+    // Behind a busy core the process would wait out the running slice, and the idle
+    // core is not woken to take it (see wake_idle_core).
+    bool idle_elsewhere = preferred != caller_core && least_load == 0 && preferred_load > 0;
+    if (!idle_elsewhere && preferred_load <= least_load + RUN_QUEUE_IMBALANCE_THRESHOLD) return preferred;
+    if (domain_count_ == 1) return least;
+
+    int least_domain = least_loaded_domain(process->id);
+    if (domain_load(domain) <= domain_load(least_domain) + global_config.domain_imbalance) return least;
+    return least_loaded_core(least_domain, process->id);
+}
+
+// The queue 'core_id' should take its next process from, or -1 if all are empty.
+int RunQueues::choose_source(int core_id) const {
+    int own = cores_[core_id].domain;
+    if (domains_[own].queued.load(std::memory_order_relaxed) > 0) {
+        int source = choose_source_in(own, core_id);
+        if (source >= 0) return source;
+    }
+    if (domain_count_ == 1) return -1;
+
+    // Nothing queued in the core's own domain: rather than idle, it takes work from the
+    // domain holding the best key, or the most queued processes.
+    bool ordered = ReadyQueue::is_ordered(global_config.scheduler_type);
+    int best = -1;
+    int64_t best_key = ReadyQueue::NO_WAITING_KEY;
+    int most_queued = 0;
+    for (int domain = 0; domain < domain_count_; ++domain) {
+        if (domain == own) continue;
+        if (ordered) {
+            int64_t key = domains_[domain].best_key.load(std::memory_order_relaxed);
+            if (key < best_key) {
+                best_key = key;
+                best = domain;
+            }
+        }
+        else {
+            int queued = domains_[domain].queued.load(std::memory_order_relaxed);
+            if (queued > most_queued) {
+                most_queued = queued;
+                best = domain;
+            }
+        }
+    }
+    return best < 0 ? -1 : choose_source_in(best, core_id);
+}
+
+// The queue of 'domain' that 'core_id' should take from, or -1 if they are all empty.
+int RunQueues::choose_source_in(int domain, int core_id) const {
+    const Domain& d = domains_[domain];
+    bool own_domain = cores_[core_id].domain == domain;
+
+    if (ReadyQueue::is_ordered(global_config.scheduler_type)) {
+        // The best key in the domain wins; the core's own queue wins ties.
+        int64_t best_key = d.best_key.load(std::memory_order_relaxed);
+        if (best_key == ReadyQueue::NO_WAITING_KEY) return -1;
+        if (own_domain && cores_[core_id].queue.best_waiting_key() <= best_key) return core_id;
+        return d.best_core.load(std::memory_order_relaxed);
+    }
+
+    if (own_domain && cores_[core_id].length.load(std::memory_order_relaxed) > 0) return core_id;
+
+    // Steal from the longest queue.
+    int longest = -1;
+    int longest_length = 0;
+    for (int core = d.first_core; core < d.end_core; ++core) {
+        int length = cores_[core].length.load(std::memory_order_relaxed);
+        if (length > longest_length) {
+            longest_length = length;
+            longest = core;
+        }
+    }
+    return longest;
+}
+
+int RunQueues::enqueue(Process* process, int caller_core) {
+    int core;
+    for (;;) {
+        // queued_core is only a hint until it is re-checked under that queue's lock.
+        core = process->queued_core.load();
+        bool already_queued = core >= 0;
+        if (!already_queued) core = choose_core(process, caller_core);
+
+        CoreRunQueue& rq = cores_[core];
+        std::lock_guard<std::mutex> lock(rq.mutex);
+        if (process->queued_core.load() != (already_queued ? core : -1)) continue; // Raced; retry
+
+        rq.queue.push(process);
+        update_key(core);
+        if (!already_queued) {
+            process->queued_core = core;
+            rq.length++;
+            domains_[rq.domain].queued++;
+            ready_count_++;
+        }
+        break;
+    }
+    if (core != caller_core) wake_idle_core(core);
+    return core;
+}
+
+Process* RunQueues::dequeue(int core_id) {
+    CoreRunQueue& self = cores_[core_id];
+    bool after_wakeup = self.woken.exchange(false, std::memory_order_relaxed);
+    for (int attempt = 0; attempt < core_count_ && !empty(); ++attempt) {
+        int source = choose_source(core_id);
+        if (source < 0) break;
+
+        CoreRunQueue& rq = cores_[source];
+        Process* process = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(rq.mutex);
+            process = rq.queue.pop();
+            if (!process) continue; // Emptied by another core meanwhile
+            update_key(source);
+            process->queued_core = -1;
+            rq.length--;
+            domains_[rq.domain].queued--;
+        }
+        ready_count_--;
+        set_busy(core_id, true);
+        return process;
+    }
+    set_busy(core_id, false);
+    if (after_wakeup) spurious_wakeups_++;
+    return nullptr;
+}
+
+void RunQueues::set_busy(int core, bool busy) {
+    if (cores_[core].busy.exchange(busy, std::memory_order_relaxed) != busy) {
+        domains_[cores_[core].domain].busy += busy ? 1 : -1;
+    }
+}
+
+// Moves the most recently queued process of core 'from' to core 'to', so nobody loses
+// their place in line. Returns false if 'from' had nothing queued.
+bool RunQueues::move_back(int from, int to) {
+    std::scoped_lock lock(cores_[from].mutex, cores_[to].mutex);
+    Process* process = cores_[from].queue.pop_back();
+    if (!process) return false;
+    cores_[from].length--;
+    domains_[cores_[from].domain].queued--;
+    update_key(from);
+    cores_[to].queue.push(process);
+    update_key(to);
+    process->queued_core = to;
+    cores_[to].length++;
+    domains_[cores_[to].domain].queued++;
+    return true;
+}
+
+void RunQueues::rebalance_domain(int domain) {
+    const Domain& d = domains_[domain];
+    if (d.end_core - d.first_core < 2) return;
+
+    for (int moves = 0; moves < d.end_core - d.first_core; ++moves) {
+        int longest = d.first_core;
+        int shortest = d.first_core;
+        for (int core = d.first_core + 1; core < d.end_core; ++core) {
+            int length = cores_[core].length.load(std::memory_order_relaxed);
+            if (length > cores_[longest].length.load(std::memory_order_relaxed)) longest = core;
+            if (length < cores_[shortest].length.load(std::memory_order_relaxed)) shortest = core;
+        }
+        if (longest == shortest ||
+            cores_[longest].length.load() - cores_[shortest].length.load() <= RUN_QUEUE_IMBALANCE_THRESHOLD) break;
+        if (!move_back(longest, shortest)) break;
+    }
+}
+
+void RunQueues::rebalance() {
+    for (int domain = 0; domain < domain_count_; ++domain) rebalance_domain(domain);
+    if (domain_count_ < 2) return;
+
+    for (int moves = 0; moves < core_count_; ++moves) {
+        int busiest = 0;
+        int least = 0;
+        for (int domain = 1; domain < domain_count_; ++domain) {
+            if (domain_load(domain) > domain_load(busiest)) busiest = domain;
+            if (domain_load(domain) < domain_load(least)) least = domain;
+        }
+        if (busiest == least ||
+            domain_load(busiest) - domain_load(least) <= global_config.domain_imbalance) break;
+
+        // From the longest queue of the busiest domain to the shortest of the least busy.
+        const Domain& from = domains_[busiest];
+        int longest = from.first_core;
+        for (int core = from.first_core + 1; core < from.end_core; ++core) {
+            if (cores_[core].length.load() > cores_[longest].length.load()) longest = core;
+        }
+        const Domain& to = domains_[least];
+        int shortest = to.first_core;
+        for (int core = to.first_core + 1; core < to.end_core; ++core) {
+            if (cores_[core].length.load() < cores_[shortest].length.load()) shortest = core;
+        }
+        if (!move_back(longest, shortest)) break;
+        domain_migrations_++;
+    }
+}
+
+bool RunQueues::idle() const {
+    if (!empty()) return false;
+    for (int core = 0; core < core_count_; ++core) {
+        if (cores_[core].busy.load(std::memory_order_relaxed)) return false;
+    }
+    return true;
+}
+
+void RunQueues::rekey() {
+    for (int core = 0; core < core_count_; ++core) {
+        std::lock_guard<std::mutex> lock(cores_[core].mutex);
+        cores_[core].queue.rekey();
+        update_key(core);
+    }
+}
+
+// Brings 'core's leaf of its domain's key tree up to date, and the path to the root.
+// Caller holds the core's run-queue lock, so leaf updates of one core cannot reorder;
+// key_mutex orders them with the other cores' updates of the same tree.
+void RunQueues::update_key(int core) {
+    if (!ReadyQueue::is_ordered(global_config.scheduler_type)) return;
+    Domain& d = domains_[cores_[core].domain];
+    int64_t key = cores_[core].queue.best_waiting_key();
+    int node = d.leaves + (core - d.first_core);
+
+    std::lock_guard<std::mutex> lock(d.key_mutex);
+    if (d.keys[node].key == key) return;
+    d.keys[node] = KeyNode{ key, core };
+    for (node /= 2; node >= 1; node /= 2) {
+        const KeyNode& left = d.keys[2 * node];
+        const KeyNode& right = d.keys[2 * node + 1];
+        d.keys[node] = right.key < left.key ? right : left;
+    }
+    d.best_key.store(d.keys[1].key, std::memory_order_relaxed);
+    d.best_core.store(d.keys[1].core, std::memory_order_relaxed);
+}
+
+int64_t RunQueues::best_waiting_key() const {
+    int64_t best = ReadyQueue::NO_WAITING_KEY;
+    for (int domain = 0; domain < domain_count_; ++domain) {
+        best = std::min(best, domains_[domain].best_key.load(std::memory_order_relaxed));
+    }
+    return best;
+}
+
+// The parking core sets its idle bit before it checks for work, and enqueue() raises
+// ready_count_ before it looks for an idle bit, so one of the two always sees the other.
+bool RunQueues::park(int core_id) {
+    uint64_t bit = uint64_t(1) << (core_id % 64);
+    std::atomic<uint64_t>& word = idle_mask_[core_id / 64];
+
+    word.fetch_or(bit);
+    if (!empty() || !system_running) {
+        word.fetch_and(~bit);
+        return false;
+    }
+    return true;
+}
+
+void RunQueues::unpark(int core_id) {
+    idle_mask_[core_id / 64].fetch_and(~(uint64_t(1) << (core_id % 64)));
+}
+
+// Atomically takes 'core' out of the idle set. Only the caller that cleared the bit
+// wakes the core, so each parked core is woken once.
+bool RunQueues::claim_idle_core(int core) {
+    uint64_t bit = uint64_t(1) << (core % 64);
+    return (idle_mask_[core / 64].fetch_and(~bit) & bit) != 0;
+}
+
+// Claims and wakes a parked core in [first_core, end_core). False if there is none.
+bool RunQueues::wake_idle_in(int first_core, int end_core) {
+    for (int word = first_core / 64; word * 64 < end_core; ++word) {
+        uint64_t idle = idle_mask_[word].load();
+        for (int bit = 0; idle != 0; ++bit, idle >>= 1) {
+            if ((idle & 1) == 0) continue;
+            int core = word * 64 + bit;
+            if (core < first_core || core >= end_core) continue;
+            if (claim_idle_core(core)) {
+                wake(core);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void RunQueues::wake_idle_core(int preferred_core) {
+    if (preferred_core >= 0 && claim_idle_core(preferred_core)) {
+        wake(preferred_core);
+        return;
+    }
+    // 'preferred_core' is not parked, so it takes a lone queued process at its next
+    // dispatch; waking a thief for it mostly finds the work already gone. Only a
+    // backlog is worth another core: any parked one, in the same domain first.
+    if (preferred_core >= 0) {
+        if (cores_[preferred_core].length.load(std::memory_order_relaxed) <= 1) return;
+        const Domain& d = domains_[cores_[preferred_core].domain];
+        if (wake_idle_in(d.first_core, d.end_core)) return;
+    }
+    wake_idle_in(0, core_count_);
+}
+
+void RunQueues::wake(int core) {
+    cores_[core].woken.store(true, std::memory_order_relaxed);
+    resume_core(core);
+    wakeups_++;
+}
+
+void RunQueues::wake_all() {
+    for (int core = 0; core < core_count_; ++core) {
+        resume_core(core);
+    }
+}
@@ -0,0 +1,153 @@
+#ifndef RUN_QUEUES_H
+#define RUN_QUEUES_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "ready_queue.h"
+
+// Runnable processes that differ in load by no more than this are left where they are.
+const int RUN_QUEUE_IMBALANCE_THRESHOLD = 1;
+
+// Clock ticks between global rebalancing passes (see RunQueues::rebalance).
+const uint64_t RUN_QUEUE_REBALANCE_TICKS = 10;
+
+// One ReadyQueue per CPU core, each behind its own lock, so dispatching and
+// requeueing do not serialize every core on queue_mutex. The cores are grouped into
+// scheduling domains (sched_domains.h), and work stays inside its domain where it can:
+//   - A process is queued on its last core unless that core is overloaded, in which
+//     case it goes to the least-loaded core of the same domain, unless that whole
+//     domain is more than domain-imbalance busier than the least-loaded one. New
+//     processes go to the least-loaded core of the least-loaded domain.
+//   - A core takes work from its own queue. With FCFS/RR it steals from the longest
+//     queue of its domain when its own is empty; with the ordered policies it takes
+//     the best-keyed process in its domain, so the policy holds domain-wide. Only a
+//     core whose whole domain has nothing queued looks in the other domains.
+//   - rebalance() evens out queue lengths within each domain, then moves processes
+//     between domains whose loads differ by more than domain-imbalance.
+// With one domain (the default) this is plain per-core queues with stealing.
+//
+// An idle core parks (suspends on the core pool) and sets its bit in an idle-core
+// bitmap. Each enqueue wakes at most one parked core instead of waking every core to
+// race for the work: the core the process was queued on, or, if that core is busy
+// with more than one process queued, a parked core to steal one, from its domain first.
+//
+// With the ordered policies each domain keeps its cores' best keys in a tournament
+// tree, updated under the core's run-queue lock as its queue changes, so dispatch finds
+// the domain's best process in O(1) and an update costs O(log cores).
+//
+// Lock order: queue_mutex, then run-queue locks, then a domain's key_mutex. At most two
+// run-queue locks are held at once, and only through std::scoped_lock.
+class RunQueues {
+public:
+    // Sizes the queues and splits them into 'domain_count' domains. Called once,
+    // before any core starts.
+    void init(int core_count, int domain_count = 1);
+
+    // Queues 'process' (already READY) and returns the core it was queued on. A
+    // process already queued somewhere is re-keyed in place. Wakes a parked core for
+    // it unless it went to 'caller_core', which is about to dequeue anyway.
+    int enqueue(Process* process, int caller_core = -1);
+    // Next process for 'core_id' to run, or nullptr if every queue is empty.
+    Process* dequeue(int core_id);
+    // Evens out queue lengths within each domain to RUN_QUEUE_IMBALANCE_THRESHOLD,
+    // then moves processes from the busiest to the least busy domain until their loads
+    // are within domain-imbalance.
+    void rebalance();
+    // Re-keys every queue (see ReadyQueue::rekey).
+    void rekey();
+
+    // Parks 'core_id' until it is woken (through resume_core()) for new work or the
+    // system stops. Returns false, without parking, if some queue is already
+    // non-empty or the system has stopped.
+    bool park(int core_id);
+    // Called by a parked core when it resumes. A waker clears the idle bit when it
+    // claims the core; this clears it for any other resume.
+    void unpark(int core_id);
+    // Wakes every parked core, for shutdown.
+    void wake_all();
+
+    // Wakeups after which the woken core found no work to run.
+    uint64_t spurious_wakeups() const { return spurious_wakeups_.load(std::memory_order_relaxed); }
+    uint64_t wakeups() const { return wakeups_.load(std::memory_order_relaxed); }
+    // Processes the balancer has moved to another domain.
+    uint64_t domain_migrations() const { return domain_migrations_.load(std::memory_order_relaxed); }
+
+    // No process is queued or running on any core.
+    bool idle() const;
+    bool empty() const { return ready_count_.load() == 0; }
+    size_t size() const { return static_cast<size_t>(ready_count_.load()); }
+
+    // Best key waiting on any core (see ReadyQueue::best_waiting_key). The smallest of
+    // the domains' best keys, so it can briefly lag a concurrent update.
+    int64_t best_waiting_key() const;
+    // Best key waiting in the domain of 'core_id', the one that core dispatches from.
+    int64_t best_waiting_key(int core_id) const {
+        return domains_[cores_[core_id].domain].best_key.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct alignas(64) CoreRunQueue {
+        std::mutex mutex;
+        ReadyQueue queue;
+        std::atomic<int> length{ 0 };
+        std::atomic<bool> busy{ false }; // The core is running a process
+        int domain = 0;
+
+        // Set by the waker that claimed this core's idle bit, so the next dequeue checks
+        // whether the wakeup found work.
+        std::atomic<bool> woken{ false };
+    };
+
+    struct KeyNode {
+        int64_t key = ReadyQueue::NO_WAITING_KEY;
+        int core = -1;
+    };
+
+    struct alignas(64) Domain {
+        int first_core = 0;
+        int end_core = 0;
+        std::atomic<int> queued{ 0 }; // Processes queued on the domain's cores
+        std::atomic<int> busy{ 0 };   // Cores of the domain running a process
+        // The domain's best waiting key and the core queueing it: the root of 'keys'.
+        std::atomic<int64_t> best_key{ ReadyQueue::NO_WAITING_KEY };
+        std::atomic<int> best_core{ -1 };
+
+        // Tournament tree over the best waiting keys of the domain's cores, for the
+        // ordered policies: core first_core + i is leaf 'leaves + i', and each node holds
+        // the smaller of its two children. Guarded by key_mutex.
+        std::mutex key_mutex;
+        std::unique_ptr<KeyNode[]> keys;
+        int leaves = 0;
+    };
+
+    int load_of(int core) const;
+    int domain_load(int domain) const;
+    int least_loaded_core(int domain, int offset) const;
+    int least_loaded_domain(int offset) const;
+    int choose_core(const Process* process, int caller_core) const;
+    int choose_source(int core_id) const;
+    int choose_source_in(int domain, int core_id) const;
+    void set_busy(int core, bool busy);
+    bool move_back(int from, int to);
+    void rebalance_domain(int domain);
+    void update_key(int core);
+    bool claim_idle_core(int core);
+    bool wake_idle_in(int first_core, int end_core);
+    void wake_idle_core(int preferred_core);
+    void wake(int core);
+
+    std::unique_ptr<CoreRunQueue[]> cores_;
+    int core_count_ = 0;
+    std::unique_ptr<Domain[]> domains_;
+    int domain_count_ = 0;
+    std::atomic<int> ready_count_{ 0 };
+    std::unique_ptr<std::atomic<uint64_t>[]> idle_mask_; // Bit per parked core
+    int idle_mask_words_ = 0;
+    std::atomic<uint64_t> wakeups_{ 0 };
+    std::atomic<uint64_t> spurious_wakeups_{ 0 };
+    std::atomic<uint64_t> domain_migrations_{ 0 };
+};
+
+#endif // RUN_QUEUES_H
@@ -0,0 +1,22 @@
+#ifndef SCHED_DOMAINS_H
+#define SCHED_DOMAINS_H
+
+#include <cstdint>
+
+// Scheduling domains ("sched-domains" in config.txt). The cores are split into that
+// many groups of consecutive ids, as evenly as possible. A core dispatches from its own
+// domain's run queues first (see RunQueues), and each domain's cores run on their own
+// host threads (see core_pool.h), optionally pinned to a matching share of the host's
+// CPUs. The same split is used for both.
+
+// First of 'count' items (cores, host CPUs) that belongs to 'domain' of 'domains'.
+inline int domain_first(int domain, int count, int domains) {
+    return static_cast<int>(static_cast<int64_t>(domain) * count / domains);
+}
+
+// Domain of item 'index' of 'count': the last one whose first item is at or before it.
+inline int domain_of(int index, int count, int domains) {
+    return static_cast<int>((static_cast<int64_t>(index + 1) * domains - 1) / count);
+}
+
+#endif // SCHED_DOMAINS_H
@@ -1,6 +1,7 @@
 #include "scheduler.h"
 #include "shared_globals.h"
 #include "mem_manager.h"
+#include "scheduler_policy.h"
 #include <thread>
 #include <chrono>
 #include <iostream>
@@ -10,6 +11,29 @@
 #include <algorithm>
 #include <mutex>
 
+bool deadline_admissible(const Process* candidate) {
+    if (candidate->deadline_tick == NO_DEADLINE) return true;
+    uint64_t now = cpu_ticks.load();
+    if (candidate->deadline_tick <= now) return false;
+
+    auto remaining = [](const Process* p) {
+        return static_cast<uint64_t>(std::max<int64_t>(
+            static_cast<int64_t>(p->instructions.size()) - p->program_counter, 0));
+    };
+    uint64_t demand = remaining(candidate);
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        for (const Process* p : process_list) {
+            if (p == candidate || p->finished || p->deadline_tick == NO_DEADLINE) continue;
+            if (p->deadline_tick <= candidate->deadline_tick) demand += remaining(p);
+        }
+    }
+    // Each instruction holds its core for a tick, or for delay-per-exec ticks.
+    uint64_t ticks_per_instruction = static_cast<uint64_t>(std::max(global_config.delay_per_exec, 1));
+    uint64_t capacity = static_cast<uint64_t>(global_config.num_cpu) * (candidate->deadline_tick - now);
+    return demand * ticks_per_instruction <= capacity;
+}
+
 std::string generate_unique_process_name(const std::string& base_name) {
     std::string final_name = base_name;
     int counter = 1;
@@ -38,30 +62,77 @@ std::string generate_unique_process_name(const std::string& base_name) {
 
 
 void clock_thread() {
+    std::vector<Process*> woken;
     while (system_running) {
-        cpu_ticks++;
-        if (is_initialized && global_mem_manager && (cpu_ticks.load() % 100 == 0)) {
-            global_mem_manager->snapshotMemory(cpu_ticks.load());
+        // Ticks count from 'initialize', so a seeded run does not depend on when it was typed.
+        if (!is_initialized) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(TICK_PERIOD_MS));
+            continue;
+        }
+        // The next tick's bookkeeping is done before the tick is announced, while every
+        // core in virtual time is still blocked, so none of it races a core's work.
+        uint64_t tick = cpu_ticks.load() + 1;
+
+        // Sleepers whose tick has come go back to the run queues.
+        woken.clear();
+        sleep_timers.advance(tick, woken);
+        for (Process* process : woken) {
+            process->state = ProcessState::READY;
+            run_queues.enqueue(process);
+        }
+
+        if (global_mem_manager && (tick % 100 == 0)) {
+            global_mem_manager->snapshotMemory(tick);
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (tick % RUN_QUEUE_REBALANCE_TICKS == 0) {
+            run_queues.rebalance();
+        }
+        dispatch_policy(global_config.scheduler_type, [tick](auto policy) {
+            decltype(policy)::on_tick(tick);
+        });
+        advance_tick();
+        wait_for_tick_end();
     }
+    release_tick_waiters();
 }
 
-Process* create_random_process(const std::string& name, size_t memory_size_override) {
+std::mt19937 batch_process_rng;
+std::mt19937 manual_process_rng;
+
+void seed_process_generators(const Config& config) {
+    if (config.deterministic) {
+        std::seed_seq batch_seed{ config.seed, 0u };
+        std::seed_seq manual_seed{ config.seed, 1u };
+        batch_process_rng.seed(batch_seed);
+        manual_process_rng.seed(manual_seed);
+    }
+    else {
+        std::random_device device;
+        batch_process_rng.seed(device());
+        manual_process_rng.seed(device());
+    }
+}
+
+// Uniform in [0, bound).
+static int random_below(std::mt19937& rng, int bound) {
+    return std::uniform_int_distribution<int>(0, bound - 1)(rng);
+}
+
+Process* create_random_process(const std::string& name, size_t memory_size_override, std::mt19937& rng) {
     Process* p = new Process();
     p->id = g_next_pid++;
     p->name = name;
-    p->priority = rand() % 100;
+    p->priority = random_below(rng, 100);
 
     if (memory_size_override > 0) {
         p->memory_required = memory_size_override;
     } else {
-        size_t random_mem = (rand() % (global_config.max_mem_per_proc - global_config.min_mem_per_proc + 1))
+        size_t random_mem = random_below(rng, global_config.max_mem_per_proc - global_config.min_mem_per_proc + 1)
             + global_config.min_mem_per_proc;
         p->memory_required = std::max((size_t)64, random_mem);
     }
 
-    int instruction_count = rand() % (global_config.max_ins - global_config.min_ins + 1) + global_config.min_ins;
+    int instruction_count = random_below(rng, global_config.max_ins - global_config.min_ins + 1) + global_config.min_ins;
     if (instruction_count < 1) instruction_count = 1;
 
     std::vector<Instruction> instructions;
@@ -77,27 +148,27 @@ Process* create_random_process(const std::string& name, size_t memory_size_overr
 
     for (int i = 0; i < instruction_count - 1; ++i) {
         Instruction inst;
-        int choice = rand() % 100;
+        int choice = random_below(rng, 100);
 
         if (choice < 20 && known_variables.size() < max_vars) {
             std::string new_var;
             do {
-                new_var = "v" + std::to_string(rand() % 5000);
+                new_var = "v" + std::to_string(random_below(rng, 5000));
             } while (known_variables_set.count(new_var));
             
             known_variables.push_back(new_var);
             known_variables_set.insert(new_var);
-            inst = {"DECLARE", {new_var, std::to_string(rand() % 100)}};
+            inst = {"DECLARE", {new_var, std::to_string(random_below(rng, 100))}};
         } else { 
-            int op_choice = rand() % 6; 
+            int op_choice = random_below(rng, 6); 
             if (op_choice == 0) {
-                inst = { "PRINT", {known_variables[rand() % known_variables.size()]} };
+                inst = { "PRINT", {known_variables[random_below(rng, static_cast<int>(known_variables.size()))]} };
             }
             else if (op_choice == 1) { // WRITE instruction
                 std::stringstream hex_addr;
                 size_t num_slots = p->memory_required / 2;
                 if (num_slots > 0) {
-                    size_t random_slot = rand() % num_slots;
+                    size_t random_slot = random_below(rng, static_cast<int>(num_slots));
                     uint16_t safe_address = random_slot * 2;
                     hex_addr << "0x" << std::hex << safe_address;
                 }
@@ -105,19 +176,19 @@ Process* create_random_process(const std::string& name, size_t memory_size_overr
                     hex_addr << "0x0"; 
                 }
 
-                std::string value_to_write = (rand() % 2 == 0)
-                    ? known_variables[rand() % known_variables.size()]
-                    : std::to_string(rand() % 65535);
+                std::string value_to_write = (random_below(rng, 2) == 0)
+                    ? known_variables[random_below(rng, static_cast<int>(known_variables.size()))]
+                    : std::to_string(random_below(rng, 65535));
                 inst = { "WRITE", {hex_addr.str(), value_to_write} };
             }
             else if (op_choice == 2 && !known_variables.empty()) { // READ instruction
-                std::string dest_var = known_variables[rand() % known_variables.size()];
+                std::string dest_var = known_variables[random_below(rng, static_cast<int>(known_variables.size()))];
                 std::stringstream hex_addr;
 
 
                 size_t num_slots = p->memory_required / 2;
                 if (num_slots > 0) {
-                    size_t random_slot = rand() % num_slots;
+                    size_t random_slot = random_below(rng, static_cast<int>(num_slots));
                     uint16_t safe_address = random_slot * 2;
                     hex_addr << "0x" << std::hex << safe_address;
                 }
@@ -128,10 +199,10 @@ Process* create_random_process(const std::string& name, size_t memory_size_overr
                 inst = { "READ", {dest_var, hex_addr.str()} };
             }
             else { // Default to ADD/SUBTRACT
-                std::string dest = known_variables[rand() % known_variables.size()];
-                std::string op1 = known_variables[rand() % known_variables.size()];
-                std::string op2 = (rand() % 2 == 0) ? known_variables[rand() % known_variables.size()] : std::to_string(rand() % 100);
-                inst = { (rand() % 2 == 0 ? "ADD" : "SUBTRACT"), {dest, op1, op2} };
+                std::string dest = known_variables[random_below(rng, static_cast<int>(known_variables.size()))];
+                std::string op1 = known_variables[random_below(rng, static_cast<int>(known_variables.size()))];
+                std::string op2 = (random_below(rng, 2) == 0) ? known_variables[random_below(rng, static_cast<int>(known_variables.size()))] : std::to_string(random_below(rng, 100));
+                inst = { (random_below(rng, 2) == 0 ? "ADD" : "SUBTRACT"), {dest, op1, op2} };
             }
         }
         instructions.push_back(inst);
@@ -146,6 +217,9 @@ void process_generator_thread() {
     uint64_t last_gen_tick = 0;
     while (system_running) {
         if (generating_processes) {
+            // Visit every tick so no batch-process-freq tick is skipped; in virtual time
+            // the clock also waits for this thread before it moves on.
+            join_tick_barrier();
             uint64_t current_tick = cpu_ticks.load();
             if (!pending_memory_queue.empty()) {
                 std::lock_guard<std::mutex> lock(queue_mutex);
@@ -155,8 +229,7 @@ void process_generator_thread() {
                     pending_memory_queue.pop();
                     if (global_mem_manager->createProcess(*proc_to_retry)) {
                         std::cout << "[Generator] Successfully allocated memory for pending process " << proc_to_retry->name << std::endl;
-                        ready_queue.push(proc_to_retry);
-                        queue_cv.notify_one();
+                        run_queues.enqueue(proc_to_retry);
                     }
                     else {
                         pending_memory_queue.push(proc_to_retry);
@@ -170,12 +243,14 @@ void process_generator_thread() {
                 std::string base_name = "p" + std::to_string(g_next_pid.load());
                 std::string unique_name = generate_unique_process_name(base_name);
 
-                Process* new_proc = create_random_process(unique_name, 0);
+                Process* new_proc = create_random_process(unique_name, 0, batch_process_rng);
+                if (global_config.batch_deadline > 0) {
+                    new_proc->deadline_tick = current_tick + global_config.batch_deadline;
+                }
                 if (global_mem_manager->createProcess(*new_proc)) {
                     std::lock_guard<std::mutex> lock(queue_mutex);
                     process_list.push_back(new_proc);
-                    ready_queue.push(new_proc);
-                    queue_cv.notify_all();
+                    run_queues.enqueue(new_proc);
                 }
                 else {
                     //std::cout << "\n[Generator] Memory full. Moving new process " << new_proc->name << " to pending queue." << std::endl;
@@ -184,7 +259,11 @@ void process_generator_thread() {
                     pending_memory_queue.push(new_proc);
                 }
             }
+            wait_for_tick(current_tick + 1);
+            continue;
         }
+        leave_tick_barrier();
         std::this_thread::sleep_for(std::chrono::milliseconds(20));
     }
+    leave_tick_barrier();
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef SCHEDULER_H
 #define SCHEDULER_H
 
+#include <random>
+#include "config.h"
 #include "process.h"
 
 // The main loop for the thread that increments the global CPU tick counter.
@@ -8,8 +10,22 @@ void clock_thread();
 
 std::string generate_unique_process_name(const std::string& base_name);
 
-// Creates a new random process
-Process* create_random_process(const std::string& name, size_t memory_size);
+// Random streams for create_random_process(), one per source of processes, so those
+// made with screen -s do not shift the batch generator's sequence.
+extern std::mt19937 batch_process_rng;
+extern std::mt19937 manual_process_rng;
+// Seeds both streams from config.seed in deterministic mode, otherwise from
+// std::random_device.
+void seed_process_generators(const Config& config);
+
+// EDF admission test for a process about to be admitted with a deadline: whether it and
+// every unfinished process due no later than it can finish on num-cpu cores by its
+// deadline. A process's demand is its remaining top-level instructions (the SRTF
+// estimate) times the ticks each takes. True for a process without a deadline.
+bool deadline_admissible(const Process* candidate);
+
+// Creates a new random process, drawing everything from 'rng'.
+Process* create_random_process(const std::string& name, size_t memory_size, std::mt19937& rng);
 
 // The main loop for the thread that generates processes.
 void process_generator_thread();
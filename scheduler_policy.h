@@ -0,0 +1,136 @@
+#ifndef SCHEDULER_POLICY_H
+#define SCHEDULER_POLICY_H
+
+#include <cstdint>
+#include "config.h"
+#include "process.h"
+#include "ready_queue.h"
+#include "shared_globals.h"
+#include "mlfq.h"
+#include "cfs.h"
+
+// Scheduling policies as compile-time plugins. Each policy is a struct of static
+// hooks and constants, and the code that runs per instruction (the core loop in
+// cpu_core.cpp) is instantiated once per policy, so it never switches on
+// scheduler_type. A policy provides:
+//   ordered             The ready queue is a heap on key(); otherwise a FIFO.
+//   uses_quantum        A slice ends after quantum() instructions.
+//   preemptive          A waiting process keyed below preempt_key() of the running one
+//                       takes its core.
+//   yield_on_page_fault A page fault ends the slice, like blocking I/O.
+//   key(p)              Pick-next order; lower runs first. (Called as p is queued.)
+//   preempt_key(p)      What a waiting process must beat to preempt p.
+//   quantum(p)          Slice length of p, in instructions.
+//   on_enqueue(p)       p is being queued or re-keyed; the run-queue lock is held.
+//   on_yield(p, n)      p is leaving its core after n instructions.
+//   on_tick(tick)       clock_thread is about to announce 'tick'.
+// PolicyDefaults supplies each hook; a policy declares only what it changes.
+//
+// Adding a policy takes a SchedulerType, a struct here and a case in
+// dispatch_policy(), which turns the configured type into its struct once per caller.
+
+struct PolicyDefaults {
+    static constexpr bool ordered = false;
+    static constexpr bool uses_quantum = false;
+    static constexpr bool preemptive = false;
+    static constexpr bool yield_on_page_fault = false;
+
+    static int64_t key(const Process*) { return 0; }
+    static int quantum(const Process*) { return global_config.quantum_cycles; }
+    static void on_enqueue(Process*) {}
+    static void on_yield(Process*, int) {}
+    static void on_tick(uint64_t) {}
+};
+
+struct FcfsPolicy : PolicyDefaults {};
+
+struct RoundRobinPolicy : PolicyDefaults {
+    static constexpr bool uses_quantum = true;
+};
+
+struct SjfPolicy : PolicyDefaults {
+    static constexpr bool ordered = true;
+    static int64_t key(const Process* p) { return static_cast<int64_t>(p->instructions.size()); }
+};
+
+struct SrtfPolicy : PolicyDefaults {
+    static constexpr bool ordered = true;
+    static constexpr bool preemptive = true;
+    static int64_t key(const Process* p) {
+        return static_cast<int64_t>(p->instructions.size()) - p->program_counter;
+    }
+    static int64_t preempt_key(const Process* p) { return key(p); }
+};
+
+struct PriorityNonPreemptivePolicy : PolicyDefaults {
+    static constexpr bool ordered = true;
+    static int64_t key(const Process* p) { return p->priority; }
+};
+
+struct PriorityPreemptivePolicy : PriorityNonPreemptivePolicy {
+    static constexpr bool preemptive = true;
+    static int64_t preempt_key(const Process* p) { return key(p); }
+};
+
+struct MlfqPolicy : PolicyDefaults {
+    static constexpr bool ordered = true;
+    static constexpr bool uses_quantum = true;
+    static constexpr bool preemptive = true;
+    static constexpr bool yield_on_page_fault = true;
+
+    static int64_t key(const Process* p) { return mlfq_key(p->mlfq_level, p->ready_seq); }
+    // Only a higher level preempts, not an earlier arrival at the same level.
+    static int64_t preempt_key(const Process* p) { return mlfq_key(p->mlfq_level, 0); }
+    static int quantum(const Process* p) { return mlfq_quantum(p->mlfq_level); }
+    static void on_enqueue(Process* p) { mlfq_enqueue(p); }
+    static void on_yield(Process* p, int executed) { mlfq_end_slice(p, executed); }
+    static void on_tick(uint64_t tick) {
+        if (tick % global_config.mlfq_boost_ticks == 0) mlfq_boost();
+    }
+};
+
+struct CfsPolicy : PolicyDefaults {
+    static constexpr bool ordered = true;
+    static constexpr bool uses_quantum = true;
+
+    static int64_t key(const Process* p) { return static_cast<int64_t>(p->vruntime); }
+    static int quantum(const Process* p) { return cfs_slice(p); }
+    static void on_enqueue(Process* p) {
+        if (p->ready_index == NOT_QUEUED) cfs_place(p);
+    }
+    static void on_yield(Process* p, int executed) { cfs_end_slice(p, executed); }
+};
+
+struct EdfPolicy : PolicyDefaults {
+    static constexpr bool ordered = true;
+    static constexpr bool preemptive = true;
+
+    // Processes without a deadline run, in pid order, when no deadline is waiting.
+    // One below NO_WAITING_KEY, so a queue holding only those still counts as non-empty.
+    static int64_t key(const Process* p) {
+        return p->deadline_tick == NO_DEADLINE
+            ? ReadyQueue::NO_WAITING_KEY - 1
+            : static_cast<int64_t>(p->deadline_tick);
+    }
+    static int64_t preempt_key(const Process* p) { return key(p); }
+};
+
+// Calls visit(Policy{}) with the struct of 'type'. An unknown type, which config
+// validation never lets through, falls back to FCFS.
+template <typename Visitor>
+decltype(auto) dispatch_policy(SchedulerType type, Visitor&& visit) {
+    switch (type) {
+    case SchedulerType::RR: return visit(RoundRobinPolicy{});
+    case SchedulerType::SJF: return visit(SjfPolicy{});
+    case SchedulerType::SRTF: return visit(SrtfPolicy{});
+    case SchedulerType::PRIORITY_NONPREEMPTIVE: return visit(PriorityNonPreemptivePolicy{});
+    case SchedulerType::PRIORITY_PREEMPTIVE: return visit(PriorityPreemptivePolicy{});
+    case SchedulerType::MLFQ: return visit(MlfqPolicy{});
+    case SchedulerType::CFS: return visit(CfsPolicy{});
+    case SchedulerType::EDF: return visit(EdfPolicy{});
+    case SchedulerType::FCFS:
+    default: return visit(FcfsPolicy{});
+    }
+}
+
+#endif // SCHEDULER_POLICY_H
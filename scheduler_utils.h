@@ -3,12 +3,33 @@
 
 #include "shared_globals.h"
 #include "process.h"	
+#include "scheduler_policy.h"
 
 
-Process* select_process();
-bool should_preempt();
-bool uses_quantum();
-bool should_yield(Process* process,int executed, bool preempt, bool quantum);
+Process* select_process(int core_id);
+
+// Whether 'current' should give up its core after 'executed' instructions of its
+// slice under Policy. Compiles down to only the checks Policy uses.
+template <typename Policy>
+bool should_yield(const Process* current, int executed) {
+    if constexpr (Policy::uses_quantum) {
+        if (executed >= Policy::quantum(current)) return true;
+    }
+
+    // A page fault ends the slice like blocking I/O (MLFQ moves the process up for it).
+    if constexpr (Policy::yield_on_page_fault) {
+        if (current->had_page_fault || current->paged_in) return true;
+    }
+
+    // Preempt when a process waiting in this core's domain has a strictly better key:
+    // lower priority value for priority_p, fewer remaining instructions for SRTF, a
+    // higher level for MLFQ, an earlier deadline for EDF.
+    if constexpr (Policy::preemptive) {
+        if (run_queues.best_waiting_key(current->assigned_core) < Policy::preempt_key(current)) return true;
+    }
+
+    return false;
+}
 
 
 #endif
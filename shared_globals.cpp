@@ -1,7 +1,4 @@
 #include "shared_globals.h"
-#include <chrono>
-#include <iomanip>
-#include <sstream>
 
 // --- System Clock Definition ---
 std::atomic<uint64_t> cpu_ticks(0);
@@ -21,8 +18,8 @@ MemoryManager* global_mem_manager = nullptr;
 
 // --- Process Management Definitions ---
 std::mutex queue_mutex;
-std::condition_variable queue_cv;
-std::queue<Process*> ready_queue;
+RunQueues run_queues;
+TimerWheel sleep_timers;
 std::vector<Process*> process_list;
 std::queue<Process*> pending_memory_queue;
 std::vector<bool> core_busy;
@@ -31,18 +28,3 @@ std::atomic<int> g_next_pid(1);
 
 // --- Utility Definitions ---
 std::atomic<int> global_quantum_cycle = 0;
-
-std::string get_timestamp() {
-    auto now = std::chrono::system_clock::now();
-    time_t time = std::chrono::system_clock::to_time_t(now);
-    tm local_tm;
-#if defined(_WIN32) || defined(_WIN64)
-    localtime_s(&local_tm, &time); // Windows
-#else
-    localtime_r(&time, &local_tm); // POSIX (macOS/Linux)
-#endif
-
-    std::stringstream ss;
-    ss << std::put_time(&local_tm, "(%m/%d/%Y %I:%M:%S%p)");
-    return ss.str();
-}
\ No newline at end of file
@@ -13,11 +13,13 @@ class MemoryManager;
 #include <cstdint>
 #include "config.h"
 #include "process.h"
-
-const uint16_t SYMBOL_TABLE_SIZE = 64;
+#include "timestamp.h"
+#include "run_queues.h"
+#include "timer_wheel.h"
+#include "tick_clock.h"
 
 // --- System Clock ---
-extern std::atomic<uint64_t> cpu_ticks;
+extern std::atomic<uint64_t> cpu_ticks; // Advanced through tick_clock.h
 
 // --- Process Generation ---
 extern std::atomic<bool> generating_processes;
@@ -34,8 +36,8 @@ extern MemoryManager* global_mem_manager;
 
 // --- Process Management ---
 extern std::mutex queue_mutex; 
-extern std::condition_variable queue_cv;
-extern std::queue<Process*> ready_queue;
+extern RunQueues run_queues; // Per-core ready queues
+extern TimerWheel sleep_timers; // WAITING processes, driven by clock_thread
 extern std::vector<Process*> process_list;
 extern std::queue<Process*> pending_memory_queue;
 extern std::vector<bool> core_busy;
@@ -43,7 +45,6 @@ extern std::vector<bool> core_busy;
 extern std::atomic<int> g_next_pid;
 
 // --- Utility ---
-std::string get_timestamp();
 extern std::atomic<int> global_quantum_cycle;
 
 #endif // SHARED_GLOBALS_H
\ No newline at end of file
@@ -0,0 +1,291 @@
+#include "tick_clock.h"
+#include "shared_globals.h"
+#include "core_pool.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+// cpu_ticks only changes under tick_mutex, so a thread in wait_for_tick() cannot miss
+// the notify between checking the tick and blocking.
+static std::mutex tick_mutex;
+static std::condition_variable tick_cv;    // Threads blocked in wait_for_tick()
+static std::condition_variable barrier_cv; // clock_thread waits here for the members
+
+// A member waiting for a tick after the current one has arrived; 'running_members'
+// counts the others, and the tick is complete once it drops to 0. Cores keep it with
+// atomics alone, so a core's wait before each instruction does not take tick_mutex;
+// only the member that completes a virtual-time tick locks it, to wake the clock.
+// Deterministic mode takes tick_mutex throughout, as its members run one at a time.
+static std::atomic<int> barrier_members{ 0 };
+static std::atomic<int> core_members{ 0 };
+static std::atomic<int> running_members{ 0 };
+
+// Tick each member is waiting for, by rank (the generator 0, core i is i + 1), or 0.
+// The member and advance_tick() race to clear it once the tick has come; whoever does
+// it with the compare-exchange counts the member as running again.
+static std::unique_ptr<std::atomic<uint64_t>[]> member_wait;
+static std::atomic<int> rank_count{ 0 };
+
+// Deterministic mode: ranks of the members due in the current tick that have not
+// finished it yet. The lowest rank runs. Guarded by tick_mutex.
+static std::set<int> turnstile;
+
+static thread_local bool is_member = false;
+static const int GENERATOR_RANK = 0;
+
+// A core's side of the barrier. Cores move between host threads, so this is kept per
+// core instead of thread_local. Only the core's own steps touch it.
+struct CoreMember {
+    bool joined = false;
+    bool waiting = false;
+};
+static std::unique_ptr<CoreMember[]> core_state;
+
+static int rank_of_core(int core_id) { return core_id + 1; }
+
+void init_tick_barrier(int core_count) {
+    core_state.reset(new CoreMember[core_count]);
+    member_wait.reset(new std::atomic<uint64_t>[core_count + 1]);
+    for (int rank = 0; rank <= core_count; ++rank) member_wait[rank] = 0;
+    rank_count.store(core_count + 1);
+}
+
+// The member is waiting for a later tick. Wakes the clock if that completes the tick.
+static void arrive() {
+    if (running_members.fetch_sub(1) == 1 && global_config.virtual_time) {
+        std::lock_guard<std::mutex> lock(tick_mutex);
+        barrier_cv.notify_one();
+    }
+}
+
+// Ends the wait of 'rank' if it is still on. Returns true if this call ended it.
+static bool end_wait(int rank) {
+    uint64_t tick = member_wait[rank].load();
+    if (tick == 0 || !member_wait[rank].compare_exchange_strong(tick, 0)) return false;
+    running_members++;
+    return true;
+}
+
+// Resumes the core whose turn it is, if it is a core's. Caller holds tick_mutex.
+static void grant_turn() {
+    if (!turnstile.empty() && *turnstile.begin() != GENERATOR_RANK) {
+        resume_core(*turnstile.begin() - 1);
+    }
+}
+
+void advance_tick() {
+    {
+        std::lock_guard<std::mutex> lock(tick_mutex);
+        uint64_t now = ++cpu_ticks;
+        // Ranks in order, so the turnstile fills in turn order.
+        int ranks = rank_count.load();
+        for (int rank = 0; rank < ranks; ++rank) {
+            uint64_t tick = member_wait[rank].load();
+            if (tick == 0 || tick > now || !end_wait(rank)) continue;
+            if (global_config.deterministic) turnstile.insert(rank);
+            else if (rank != GENERATOR_RANK) resume_core(rank - 1);
+        }
+        if (global_config.deterministic) grant_turn();
+    }
+    tick_cv.notify_all();
+}
+
+// The member has done its work for this tick; the next one in line may run.
+// Caller holds tick_mutex.
+static void pass_turn(int rank) {
+    if (turnstile.erase(rank) > 0) {
+        grant_turn();
+        tick_cv.notify_all();
+    }
+}
+
+static bool has_turn(int rank) {
+    return !global_config.deterministic || turnstile.empty() || *turnstile.begin() == rank;
+}
+
+bool wait_for_tick(uint64_t tick) {
+    if (cpu_ticks.load() >= tick && !is_member) return true;
+    std::unique_lock<std::mutex> lock(tick_mutex);
+    if (!is_member) {
+        tick_cv.wait(lock, [tick] { return cpu_ticks.load() >= tick || !system_running; });
+        return cpu_ticks.load() >= tick;
+    }
+    if (cpu_ticks.load() >= tick) return true;
+
+    pass_turn(GENERATOR_RANK);
+    member_wait[GENERATOR_RANK] = tick;
+    running_members--;
+    barrier_cv.notify_one();
+    tick_cv.wait(lock, [] {
+        if (!system_running) return true;
+        return member_wait[GENERATOR_RANK].load() == 0 && has_turn(GENERATOR_RANK);
+    });
+    end_wait(GENERATOR_RANK);
+    return cpu_ticks.load() >= tick;
+}
+
+// core_wait_for_tick() in deterministic mode, where the turnstile needs tick_mutex.
+static bool core_wait_in_turn(int core_id, uint64_t tick) {
+    std::lock_guard<std::mutex> lock(tick_mutex);
+    CoreMember& member = core_state[core_id];
+    int rank = rank_of_core(core_id);
+    if (!member.waiting) {
+        if (cpu_ticks.load() >= tick || !system_running) return true;
+        pass_turn(rank);
+        member_wait[rank] = tick;
+        member.waiting = true;
+        running_members--;
+        barrier_cv.notify_one();
+        return false;
+    }
+
+    // Resumed: check that the tick and the turn have really come.
+    if (system_running && (member_wait[rank].load() != 0 || !has_turn(rank))) return false;
+    end_wait(rank);
+    member.waiting = false;
+    return true;
+}
+
+bool core_wait_for_tick(int core_id, uint64_t tick) {
+    if (global_config.deterministic) return core_wait_in_turn(core_id, tick);
+
+    CoreMember& member = core_state[core_id];
+    int rank = rank_of_core(core_id);
+    if (!member.waiting) {
+        if (cpu_ticks.load() >= tick || !system_running) return true;
+        member_wait[rank] = tick;
+        member.waiting = true;
+        arrive();
+    }
+
+    // Either advance_tick() saw the wait and ends it, or this sees the tick that came
+    // meanwhile: both the wait and cpu_ticks are sequentially consistent.
+    if (member_wait[rank].load() != 0 && system_running && cpu_ticks.load() < tick) return false;
+    end_wait(rank);
+    member.waiting = false;
+    return true;
+}
+
+void release_tick_waiters() {
+    {
+        std::lock_guard<std::mutex> lock(tick_mutex);
+        int ranks = rank_count.load();
+        for (int rank = 1; rank < ranks; ++rank) {
+            if (member_wait[rank].load() != 0) resume_core(rank - 1);
+        }
+    }
+    tick_cv.notify_all();
+    barrier_cv.notify_all();
+}
+
+void join_tick_barrier() {
+    if (is_member) return;
+    {
+        std::lock_guard<std::mutex> lock(tick_mutex);
+        is_member = true;
+        barrier_members++;
+        running_members++;
+    }
+    barrier_cv.notify_one();
+    if (global_config.deterministic) wait_for_tick(cpu_ticks.load() + 1);
+}
+
+void leave_tick_barrier() {
+    if (!is_member) return;
+    {
+        std::lock_guard<std::mutex> lock(tick_mutex);
+        is_member = false;
+        barrier_members--;
+        running_members--;
+        pass_turn(GENERATOR_RANK);
+    }
+    barrier_cv.notify_one();
+}
+
+bool core_join_tick_barrier(int core_id) {
+    if (!core_state) return false; // Barrier not set up (no cores started)
+    CoreMember& member = core_state[core_id];
+    if (member.joined) return false;
+    member.joined = true;
+    if (global_config.deterministic) {
+        std::lock_guard<std::mutex> lock(tick_mutex);
+        barrier_members++;
+        core_members++;
+        running_members++;
+        barrier_cv.notify_one();
+        return true;
+    }
+    running_members++;
+    barrier_members++;
+    core_members++;
+    return true;
+}
+
+void core_leave_tick_barrier(int core_id) {
+    if (!core_state || !core_state[core_id].joined) return;
+    CoreMember& member = core_state[core_id];
+    int rank = rank_of_core(core_id);
+    if (global_config.deterministic) {
+        {
+            std::lock_guard<std::mutex> lock(tick_mutex);
+            if (member.waiting) end_wait(rank);
+            member = CoreMember{};
+            barrier_members--;
+            core_members--;
+            running_members--;
+            pass_turn(rank);
+        }
+        barrier_cv.notify_one();
+        return;
+    }
+    if (member.waiting) end_wait(rank);
+    member = CoreMember{};
+    barrier_members--;
+    core_members--;
+    arrive();
+}
+
+// Deterministic mode: the clock holds while nothing will happen until the user acts,
+// and while the generator has been switched on but has not joined yet, so it always
+// starts on the tick after the one it was started in. Caller holds tick_mutex.
+static bool hold_deterministic_clock() {
+    bool generator_joined = barrier_members > core_members;
+    if (generating_processes) return !generator_joined;
+    return run_queues.idle() && sleep_timers.size() == 0;
+}
+
+void wait_for_tick_end() {
+    const auto period = std::chrono::milliseconds(TICK_PERIOD_MS);
+    if (!global_config.virtual_time) {
+        std::this_thread::sleep_for(period);
+        return;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + period;
+    std::unique_lock<std::mutex> lock(tick_mutex);
+    while (system_running) {
+        bool complete = barrier_members > 0 && running_members == 0;
+        if (global_config.deterministic) {
+            // Every core takes part in every tick; the wait only rechecks for work.
+            if (complete && core_members == global_config.num_cpu && !hold_deterministic_clock()) return;
+            barrier_cv.wait_for(lock, period);
+            continue;
+        }
+
+        // A queued process with a core free for it still belongs to this tick: the woken
+        // core joins once it dispatches. Parking is not announced, so this wait is bounded.
+        bool dispatch_pending = !run_queues.empty() && core_members < global_config.num_cpu;
+        if (complete && !dispatch_pending) return;
+
+        if (barrier_members > 0 && !complete) {
+            // Members always arrive or leave; the timeout only rechecks system_running.
+            barrier_cv.wait_for(lock, period);
+        }
+        else if (barrier_cv.wait_until(lock, deadline) == std::cv_status::timeout) {
+            return;
+        }
+    }
+}
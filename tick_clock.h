@@ -0,0 +1,54 @@
+#ifndef TICK_CLOCK_H
+#define TICK_CLOCK_H
+
+#include <cstdint>
+
+// Wall-clock length of one tick, and the longest virtual time waits on anything but
+// the barrier itself.
+const int TICK_PERIOD_MS = 10;
+
+// Tick broadcast. clock_thread advances cpu_ticks through advance_tick(), which wakes
+// every thread blocked in wait_for_tick() and resumes the cores waiting on the tick;
+// waiters sleep instead of polling.
+void advance_tick();
+// Blocks until cpu_ticks reaches 'tick'. Returns false if the system stopped first.
+bool wait_for_tick(uint64_t tick);
+// Wakes every waiter, thread or core, so it sees system_running == false.
+void release_tick_waiters();
+
+// Tick barrier, used with "virtual-time 1". The work that makes up a tick is done by
+// its members: the generator thread while it is on, and each core from dispatch until
+// it parks. A tick is over once every member is waiting for a later tick. Joining twice
+// is harmless.
+//
+// In deterministic mode (a seed in config.txt) the members due in a tick also take
+// turns: the generator first, then cores by id, each running until it waits for a
+// later tick. Cores stay members while idle, and a new member's first turn is in the
+// next tick, so no member's work overlaps another's.
+//
+// The generator is a thread and blocks in wait_for_tick(). Cores run on the core pool
+// (core_pool.h) and must not block a host thread, so they use the core_ functions,
+// which outside deterministic mode take no lock.
+//
+// Sizes the barrier for 'core_count' cores. Called once, before any core starts.
+void init_tick_barrier(int core_count);
+void join_tick_barrier();  // The calling thread
+void leave_tick_barrier();
+// Returns true if the core was not a member yet.
+bool core_join_tick_barrier(int core_id);
+void core_leave_tick_barrier(int core_id);
+// The non-blocking wait_for_tick() of a member core. Returns true if the core may go
+// on: 'tick' has come (and it is the core's turn), or the system stopped. Otherwise
+// the core is now waiting, and resume_core() is called once that may have changed;
+// the core then calls this again with the same tick.
+bool core_wait_for_tick(int core_id, uint64_t tick);
+
+// Called by clock_thread before each tick. With wall-clock pacing (the default) it
+// sleeps TICK_PERIOD_MS. In virtual time it returns once the barrier is complete and no
+// queued process is still waiting for an idle core to wake; with no members it falls
+// back to one wall-clock tick, so an idle system does not spin. In deterministic mode
+// it waits for every core to join, and holds the clock while there is nothing to run
+// or generate, so a run's ticks do not depend on how long the user takes to type.
+void wait_for_tick_end();
+
+#endif // TICK_CLOCK_H
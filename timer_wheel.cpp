@@ -0,0 +1,69 @@
+#include "timer_wheel.h"
+
+bool TimerWheel::schedule(Process* process, uint64_t due_tick) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (due_tick <= current_tick_) return false;
+    file({ due_tick, process });
+    count_++;
+    return true;
+}
+
+// Files a timer at the lowest level whose span covers its distance from the current
+// tick. Timers beyond the top level's span sit in the top level and are re-filed each
+// time their slot comes round.
+void TimerWheel::file(const Timer& timer) {
+    uint64_t delta = timer.due_tick - current_tick_;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    size_t slot = (timer.due_tick >> (SLOT_BITS * level)) & (SLOTS - 1);
+    slots_[level][slot].push_back(timer);
+}
+
+// Re-files the timers in the current slot of 'level' one or more levels down.
+void TimerWheel::cascade(int level, std::vector<Process*>& expired) {
+    size_t slot = (current_tick_ >> (SLOT_BITS * level)) & (SLOTS - 1);
+    cascading_.clear();
+    cascading_.swap(slots_[level][slot]);
+    for (const Timer& timer : cascading_) {
+        if (timer.due_tick <= current_tick_) {
+            expired.push_back(timer.process);
+            count_--;
+        }
+        else {
+            file(timer);
+        }
+    }
+}
+
+void TimerWheel::advance(uint64_t now, std::vector<Process*>& expired) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (current_tick_ < now) {
+        current_tick_++;
+        if (count_ == 0) {
+            // Nothing filed: skip straight to 'now'.
+            current_tick_ = now;
+            break;
+        }
+
+        // Each time a level wraps, the next level's current slot comes down.
+        for (int level = 1; level < LEVELS; ++level) {
+            uint64_t lower_mask = (uint64_t(1) << (SLOT_BITS * level)) - 1;
+            if ((current_tick_ & lower_mask) != 0) break;
+            cascade(level, expired);
+        }
+
+        std::vector<Timer>& due = slots_[0][current_tick_ & (SLOTS - 1)];
+        for (const Timer& timer : due) {
+            expired.push_back(timer.process);
+        }
+        count_ -= due.size();
+        due.clear();
+    }
+}
+
+size_t TimerWheel::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_;
+}
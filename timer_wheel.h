@@ -0,0 +1,47 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "process.h"
+
+// Hierarchical timing wheel holding sleeping (WAITING) processes until their
+// sleep_until_tick. Level 0 has one slot per tick for the next 64 ticks; each level
+// above covers 64 times the span of the one below. A process is filed at the lowest
+// level whose span reaches its due tick and moves down a level each time the slot it
+// sits in comes round ("cascading"), so scheduling and expiry are O(1) per process
+// per level instead of scanning every sleeper on every tick.
+class TimerWheel {
+public:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+
+    // Files 'process' to be returned by advance() once the clock reaches 'due_tick'.
+    // Returns false, without filing it, if that tick has already been reached.
+    bool schedule(Process* process, uint64_t due_tick);
+
+    // Moves the wheel forward to tick 'now' and appends every process that has
+    // become due to 'expired'.
+    void advance(uint64_t now, std::vector<Process*>& expired);
+
+    size_t size() const;
+
+private:
+    struct Timer {
+        uint64_t due_tick;
+        Process* process;
+    };
+
+    void file(const Timer& timer);
+    void cascade(int level, std::vector<Process*>& expired);
+
+    mutable std::mutex mutex_;
+    uint64_t current_tick_ = 0; // Last tick processed by advance()
+    size_t count_ = 0;
+    std::vector<Timer> slots_[LEVELS][SLOTS];
+    std::vector<Timer> cascading_; // Scratch for cascade(), kept to reuse its capacity
+};
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,34 @@
+#include "timestamp.h"
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+TimestampId current_timestamp_id() {
+    return std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+}
+
+const std::string& format_timestamp(TimestampId id) {
+    static const std::string empty;
+    thread_local TimestampId cached_id = NO_TIMESTAMP;
+    thread_local std::string cached_text;
+
+    if (id == NO_TIMESTAMP) return empty;
+    if (id == cached_id) return cached_text;
+
+    tm local_tm;
+#if defined(_WIN32) || defined(_WIN64)
+    localtime_s(&local_tm, &id); // Windows
+#else
+    localtime_r(&id, &local_tm); // POSIX (macOS/Linux)
+#endif
+
+    std::stringstream ss;
+    ss << std::put_time(&local_tm, "(%m/%d/%Y %I:%M:%S%p)");
+    cached_text = ss.str();
+    cached_id = id;
+    return cached_text;
+}
+
+std::string get_timestamp() {
+    return format_timestamp(current_timestamp_id());
+}
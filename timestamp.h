@@ -0,0 +1,23 @@
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <ctime>
+#include <string>
+
+// A wall-clock time at one-second resolution (seconds since the epoch). Processes and
+// log records store this id and format it only when it is displayed.
+using TimestampId = time_t;
+const TimestampId NO_TIMESTAMP = 0;
+
+// The current wall-clock second. Cheap and lock-free.
+TimestampId current_timestamp_id();
+
+// "(MM/DD/YYYY hh:mm:ssAM)" for the given second, or "" for NO_TIMESTAMP. Each thread
+// caches its last result, so a second is formatted at most once per thread. The
+// reference stays valid until the calling thread's next call.
+const std::string& format_timestamp(TimestampId id);
+
+// format_timestamp(current_timestamp_id())
+std::string get_timestamp();
+
+#endif // TIMESTAMP_H